@@ -0,0 +1,62 @@
+#include "AsyncEngineLoader.h"
+
+AsyncEngineLoader::AsyncEngineLoader(VST2Loader& loaderToUse, juce::CriticalSection& engineLock)
+    : juce::Thread("Altiverb Loader"),
+      loader(loaderToUse),
+      lock(engineLock)
+{
+}
+
+AsyncEngineLoader::~AsyncEngineLoader() {
+    // loadPlugin can't be interrupted - let it finish before the loader goes away
+    waitUntilSettled();
+}
+
+bool AsyncEngineLoader::startLoading(const juce::String& path, std::function<void()> onLoaded) {
+    if (isLoading()) {
+        return false;
+    }
+
+    // The previous load's thread has finished its work but may not have exited yet
+    waitForThreadToExit(-1);
+
+    pendingPath = path;
+    pendingCallback = std::move(onLoaded);
+    state.store(State::loading, std::memory_order_release);
+
+    if (!startThread()) {
+        state.store(State::failed, std::memory_order_release);
+        return false;
+    }
+
+    return true;
+}
+
+void AsyncEngineLoader::waitUntilSettled() {
+    waitForThreadToExit(-1);
+}
+
+void AsyncEngineLoader::unload() {
+    jassert(!isLoading());
+
+    loader.unloadPlugin();
+    state.store(State::unloaded, std::memory_order_release);
+}
+
+void AsyncEngineLoader::run() {
+    // The slow part - nobody else touches the loader while the state is `loading`
+    bool loaded = loader.loadPlugin(pendingPath);
+
+    const juce::ScopedLock sl(lock);
+
+    if (!loaded) {
+        state.store(State::failed, std::memory_order_release);
+        return;
+    }
+
+    if (pendingCallback) {
+        pendingCallback();
+    }
+
+    state.store(State::ready, std::memory_order_release);
+}
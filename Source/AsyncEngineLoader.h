@@ -0,0 +1,54 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include "VST2Loader.h"
+
+// Loads the VST2 engine on a background thread so the DAW's message thread
+// never waits for Altiverb to initialise.
+//
+// Readiness protocol: the state only becomes `ready` after the onLoaded
+// callback has configured the engine, and both happen under the owner's
+// engine lock. Threads that take that lock (prepare, state restore) see a
+// consistent state; the audio thread only reads the atomic and stays in
+// passthrough until it turns `ready`.
+class AsyncEngineLoader : private juce::Thread {
+public:
+    enum class State {
+        unloaded,
+        loading,
+        ready,
+        failed
+    };
+
+    AsyncEngineLoader(VST2Loader& loader, juce::CriticalSection& engineLock);
+    ~AsyncEngineLoader() override;
+
+    // Start loading in the background. onLoaded runs on the loading thread with
+    // the engine lock held, just before the engine is published as ready.
+    // Returns false if a load is already in progress.
+    bool startLoading(const juce::String& path, std::function<void()> onLoaded);
+
+    State getState() const noexcept { return state.load(std::memory_order_acquire); }
+    bool isReady() const noexcept { return getState() == State::ready; }
+    bool isLoading() const noexcept { return getState() == State::loading; }
+
+    // Block until any load in progress has finished (offline rendering, shutdown)
+    void waitUntilSettled();
+
+    // Engine lock held, not while loading: unload the engine and start over
+    void unload();
+
+private:
+    VST2Loader& loader;
+    juce::CriticalSection& lock;
+    std::atomic<State> state { State::unloaded };
+
+    // Only touched by the message thread before the load starts and by run()
+    juce::String pendingPath;
+    std::function<void()> pendingCallback;
+
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AsyncEngineLoader)
+};
@@ -0,0 +1,543 @@
+#include "BridgeClient.h"
+
+#if JUCE_WINDOWS
+  #include <Windows.h>
+#else
+  #include <unistd.h>
+#endif
+
+using namespace BridgeProtocol;
+
+static juce::File helperExecutableOverride;
+
+static juce::String getProcessIdString() {
+    #if JUCE_WINDOWS
+    return juce::String((int)GetCurrentProcessId());
+    #else
+    return juce::String((int)getpid());
+    #endif
+}
+
+static double ticksToMicroseconds(juce::int64 ticks) {
+    return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+}
+
+//==============================================================================
+// BridgeHostConnection
+
+BridgeHostConnection::BridgeHostConnection() {
+}
+
+BridgeHostConnection::~BridgeHostConnection() {
+    if (header && helper.isRunning()) {
+        Message message;
+        message.opcode = bridgeShutdown;
+        lane.call(message, message, 1000);
+
+        if (!helper.waitForProcessToFinish(1000)) {
+            helper.kill();
+        }
+    }
+
+    lane.close();
+    session.close();
+}
+
+juce::File BridgeHostConnection::getHelperExecutable() {
+    if (helperExecutableOverride.getFullPathName().isNotEmpty()) {
+        return helperExecutableOverride;
+    }
+
+    // Shipped next to the wrapper binary inside the VST3 bundle
+    auto wrapperBinary = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
+    #if JUCE_WINDOWS
+    return wrapperBinary.getSiblingFile("AltiverbBridgeHost.exe");
+    #else
+    return wrapperBinary.getSiblingFile("AltiverbBridgeHost");
+    #endif
+}
+
+void BridgeHostConnection::setHelperExecutable(const juce::File& executable) {
+    helperExecutableOverride = executable;
+}
+
+bool BridgeHostConnection::ensureHelperRunning() {
+    if (header && helper.isRunning() && header->serverState.load() == serverReady) {
+        return true;
+    }
+
+    // (Re)launch with a fresh session segment
+    lane.close();
+    session.close();
+    header = nullptr;
+
+    juce::String sessionName = "AltiverbBridge_" + getProcessIdString() + "_s" + juce::String(++launchCount);
+    if (!session.create(sessionName, sessionSegmentSize)) {
+        return false;
+    }
+
+    header = static_cast<SessionHeader*>(session.getData());
+    header->magic = magic;
+    header->version = version;
+    header->serverState.store(serverStarting);
+    header->lane.reset();
+
+    if (!lane.open(&header->lane, sessionName)) {
+        return false;
+    }
+
+    juce::StringArray arguments;
+    arguments.add(getHelperExecutable().getFullPathName());
+    arguments.add("--session");
+    arguments.add(sessionName);
+    arguments.add("--parent");
+    arguments.add(getProcessIdString());
+
+    if (!helper.start(arguments, 0)) {
+        return false;
+    }
+
+    // The helper flips the state once it has mapped the session
+    auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32)helperStartupTimeoutMs;
+    while (header->serverState.load() == serverStarting) {
+        if (juce::Time::getMillisecondCounter() >= deadline || !helper.isRunning()) {
+            return false;
+        }
+        juce::Thread::sleep(5);
+    }
+
+    return header->serverState.load() == serverReady;
+}
+
+bool BridgeHostConnection::callHelper(Message& message, const juce::String& payload) {
+    char* sessionPayload = static_cast<char*>(session.getData()) + sessionPayloadOffset;
+    size_t payloadSize = payload.getNumBytesAsUTF8() + 1;
+
+    if (payloadSize > sessionPayloadCapacity) {
+        return false;
+    }
+
+    std::memcpy(sessionPayload, payload.toRawUTF8(), payloadSize);
+    message.payloadSize = (int32_t)payloadSize;
+
+    return lane.call(message, message, controlTimeoutMs) && message.result == 1;
+}
+
+bool BridgeHostConnection::attachChannel(const juce::String& channelName, const juce::String& pluginPath) {
+    const juce::ScopedLock sl(lock);
+
+    if (!ensureHelperRunning()) {
+        return false;
+    }
+
+    Message message;
+    message.opcode = bridgeAttach;
+    return callHelper(message, channelName + "\n" + pluginPath);
+}
+
+void BridgeHostConnection::detachChannel(const juce::String& channelName) {
+    const juce::ScopedLock sl(lock);
+
+    if (!header || !helper.isRunning()) {
+        return;
+    }
+
+    Message message;
+    message.opcode = bridgeDetach;
+    callHelper(message, channelName);
+}
+
+//==============================================================================
+// BridgeClient
+
+BridgeClient::BridgeClient() {
+    std::memset(&proxy, 0, sizeof(proxy));
+}
+
+BridgeClient::~BridgeClient() {
+    detach();
+}
+
+void BridgeClient::setHelperExecutable(const juce::File& executable) {
+    BridgeHostConnection::setHelperExecutable(executable);
+}
+
+AEffect* BridgeClient::attach(const juce::String& pluginPath) {
+    detach();
+
+    static std::atomic<int> nextChannelId { 0 };
+    channelName = "AltiverbBridge_" + getProcessIdString() + "_c" + juce::String(++nextChannelId);
+
+    if (!channel.create(channelName, channelSegmentSize)) {
+        return nullptr;
+    }
+
+    header = static_cast<ChannelHeader*>(channel.getData());
+    header->magic = magic;
+    header->version = version;
+    header->serverState.store(serverStarting);
+    header->audioLane.reset();
+    header->controlLane.reset();
+    header->parameterRing.reset();
+
+    if (!audioLane.open(&header->audioLane, channelName + "_audio")
+        || !controlLane.open(&header->controlLane, channelName + "_control")
+        || !connection->attachChannel(channelName, pluginPath)
+        || header->serverState.load() != serverReady) {
+        audioLane.close();
+        controlLane.close();
+        channel.close();
+        header = nullptr;
+        return nullptr;
+    }
+
+    // Mirror the bridged effect's description into the proxy
+    const EffectInfo& info = header->effectInfo;
+    std::memset(&proxy, 0, sizeof(proxy));
+    proxy.magic = 0x56737450;  // 'VstP'
+    proxy.dispatcher = proxyDispatcher;
+    proxy.process = nullptr;
+    proxy.setParameter = proxySetParameter;
+    proxy.getParameter = proxyGetParameter;
+    proxy.numPrograms = info.numPrograms;
+    proxy.numParams = info.numParams;
+    proxy.numInputs = info.numInputs;
+    proxy.numOutputs = info.numOutputs;
+    proxy.flags = info.flags;
+    proxy.initialDelay = info.initialDelay;
+    proxy.ioRatio = 1.0f;
+    proxy.object = this;
+    proxy.uniqueID = info.uniqueID;
+    proxy.version = info.version;
+    proxy.processReplacing = proxyProcessReplacing;
+    proxy.processDoubleReplacing = nullptr;
+
+    resetRoundTripStats();
+    attached = true;
+    alive.store(true, std::memory_order_release);
+    return &proxy;
+}
+
+void BridgeClient::detach() {
+    if (!attached) {
+        return;
+    }
+
+    alive.store(false, std::memory_order_release);
+    connection->detachChannel(channelName);
+
+    audioLane.close();
+    controlLane.close();
+    channel.close();
+    header = nullptr;
+    attached = false;
+}
+
+void BridgeClient::markDead() {
+    // Helper crashed or hung - the wrapper goes silent instead of blocking the host
+    alive.store(false, std::memory_order_release);
+}
+
+bool BridgeClient::callControl(Message& message) {
+    if (!controlLane.call(message, message, controlTimeoutMs)) {
+        markDead();
+        return false;
+    }
+    return true;
+}
+
+VstIntPtr BridgeClient::dispatch(VstInt32 opcode, VstInt32 index, VstIntPtr value, void* ptr, float opt) {
+    if (!isAlive()) {
+        return 0;
+    }
+
+    const juce::ScopedLock sl(controlLock);
+
+    char* payload = getPayload(channel.getData());
+    const PointerKind kind = getPointerKind(opcode);
+    const size_t arrangementSize = sizeof(VstSpeakerArrangement);
+
+    Message message;
+    message.opcode = opcode;
+    message.index = index;
+    message.value = value;
+    message.opt = opt;
+
+    // Marshal what the plugin needs to read
+    switch (kind) {
+        case PointerKind::stringIn: {
+            if (!ptr) return 0;
+            size_t length = strnlen(static_cast<const char*>(ptr), maxStringLength - 1);
+            std::memcpy(payload, ptr, length);
+            payload[length] = 0;
+            message.payloadSize = (int32_t)length + 1;
+            break;
+        }
+
+        case PointerKind::chunkIn:
+            if (!ptr || value <= 0 || (size_t)value > payloadCapacity) return 0;
+            std::memcpy(payload, ptr, (size_t)value);
+            message.payloadSize = (int32_t)value;
+            break;
+
+        case PointerKind::speakerArrangements:
+            if (!ptr || value == 0) return 0;
+            std::memcpy(payload, reinterpret_cast<const void*>(value), arrangementSize);
+            std::memcpy(payload + arrangementSize, ptr, arrangementSize);
+            message.payloadSize = (int32_t)(2 * arrangementSize);
+            message.value = 0;
+            break;
+
+        case PointerKind::windowHandle:
+            message.value = (int64_t)reinterpret_cast<intptr_t>(ptr);
+            break;
+
+        default:
+            break;
+    }
+
+    if (!callControl(message)) {
+        return 0;
+    }
+
+    // Unmarshal what the plugin wrote
+    switch (kind) {
+        case PointerKind::stringOut:
+            if (ptr) {
+                int length = juce::jlimit(0, maxStringLength - 1, (int)message.payloadSize - 1);
+                std::memcpy(ptr, payload, (size_t)length);
+                static_cast<char*>(ptr)[length] = 0;
+            }
+            break;
+
+        case PointerKind::chunkOut:
+            if (ptr && message.result > 0 && message.payloadSize == message.result) {
+                chunkStorage.replaceAll(payload, (size_t)message.payloadSize);
+                *static_cast<void**>(ptr) = chunkStorage.getData();
+            } else {
+                message.result = 0;
+            }
+            break;
+
+        case PointerKind::speakerArrangements:
+            std::memcpy(reinterpret_cast<void*>(value), payload, arrangementSize);
+            std::memcpy(ptr, payload + arrangementSize, arrangementSize);
+            break;
+
+        case PointerKind::editorRectOut:
+            if (ptr && message.payloadSize == (int32_t)sizeof(ERect)) {
+                std::memcpy(&editorRect, payload, sizeof(ERect));
+                *static_cast<ERect**>(ptr) = &editorRect;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return (VstIntPtr)message.result;
+}
+
+void BridgeClient::process(float** inputs, float** outputs, VstInt32 sampleFrames) {
+    // The helper drains the parameter ring before it processes the block
+    if (hasOverflow.load(std::memory_order_acquire)) {
+        flushOverflowedParameters();
+    }
+
+    // The audio slots hold maxBlockSize samples - send larger blocks in pieces
+    for (int startSample = 0; startSample < sampleFrames; startSample += maxBlockSize) {
+        processPiece(inputs, outputs, startSample, juce::jmin(maxBlockSize, (int)sampleFrames - startSample));
+    }
+}
+
+void BridgeClient::processPiece(float** inputs, float** outputs, int startSample, int numSamples) {
+    const int numInputs = juce::jlimit(0, maxChannels, (int)proxy.numInputs);
+    const int numOutputs = juce::jlimit(0, maxChannels, (int)proxy.numOutputs);
+
+    if (!isAlive()) {
+        for (int ch = 0; ch < numOutputs; ++ch) {
+            juce::FloatVectorOperations::clear(outputs[ch] + startSample, numSamples);
+        }
+        return;
+    }
+
+    void* segment = channel.getData();
+    audioSlot = (audioSlot + 1) % audioSlots;
+
+    for (int ch = 0; ch < numInputs; ++ch) {
+        juce::FloatVectorOperations::copy(getAudioChannel(segment, audioSlot, false, ch), inputs[ch] + startSample, numSamples);
+    }
+
+    Message message;
+    message.opcode = bridgeProcess;
+    message.index = audioSlot;
+    message.value = numSamples;
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    bool answered = audioLane.call(message, message, audioTimeoutMs);
+    auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+
+    if (!answered) {
+        markDead();
+        for (int ch = 0; ch < numOutputs; ++ch) {
+            juce::FloatVectorOperations::clear(outputs[ch] + startSample, numSamples);
+        }
+        return;
+    }
+
+    recordRoundTrip(ticksToMicroseconds(elapsedTicks), message.serverMicroseconds);
+
+    for (int ch = 0; ch < numOutputs; ++ch) {
+        juce::FloatVectorOperations::copy(outputs[ch] + startSample, getAudioChannel(segment, audioSlot, true, ch), numSamples);
+    }
+}
+
+void BridgeClient::setParameter(VstInt32 index, float value) {
+    if (!isAlive()) {
+        return;
+    }
+
+    Message message;
+    message.opcode = bridgeSetParameter;
+    message.index = index;
+    message.opt = value;
+
+    // Fire-and-forget, and safe on the audio thread: the helper applies queued
+    // changes before its next block. While earlier changes wait in the overflow,
+    // new ones join them there, so no parameter is set out of order.
+    bool queued = false;
+    if (!hasOverflow.load(std::memory_order_acquire)) {
+        const juce::SpinLock::ScopedLockType sl(parameterLock);
+        queued = header->parameterRing.push(message);
+    }
+
+    if (!queued && juce::isPositiveAndBelow((int)index, maxOverflowParameters)) {
+        overflowValues[index].store(value, std::memory_order_relaxed);
+        overflowPending[index / 64].fetch_or((juce::uint64)1 << (index % 64), std::memory_order_release);
+        hasOverflow.store(true, std::memory_order_release);
+    }
+}
+
+void BridgeClient::flushOverflowedParameters() noexcept {
+    // Audio thread - whatever still doesn't fit stays for the next block. New changes
+    // keep joining the overflow until it is empty, so they can't overtake it.
+    for (int word = 0; word < maxOverflowParameters / 64; ++word) {
+        auto bits = overflowPending[word].exchange(0, std::memory_order_acquire);
+
+        // Only after an overflow - a plain scan of the bits does
+        for (int bit = 0; bits != 0; ++bit, bits >>= 1) {
+            if ((bits & 1) == 0) {
+                continue;
+            }
+
+            Message message;
+            message.opcode = bridgeSetParameter;
+            message.index = word * 64 + bit;
+            message.opt = overflowValues[message.index].load(std::memory_order_relaxed);
+
+            bool queued;
+            {
+                const juce::SpinLock::ScopedLockType sl(parameterLock);
+                queued = header->parameterRing.push(message);
+            }
+
+            if (!queued) {
+                overflowPending[word].fetch_or((juce::uint64)1 << bit, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Cleared first and checked again, so a change that arrived meanwhile keeps it set
+    hasOverflow.store(false, std::memory_order_seq_cst);
+    for (auto& word : overflowPending) {
+        if (word.load(std::memory_order_seq_cst) != 0) {
+            hasOverflow.store(true, std::memory_order_release);
+            break;
+        }
+    }
+}
+
+float BridgeClient::getParameter(VstInt32 index) {
+    if (!isAlive()) {
+        return 0.0f;
+    }
+
+    const juce::ScopedLock sl(controlLock);
+
+    Message message;
+    message.opcode = bridgeGetParameter;
+    message.index = index;
+
+    return callControl(message) ? message.opt : 0.0f;
+}
+
+void BridgeClient::setProcessLevel(VstInt32 level) {
+    if (!isAlive()) {
+        return;
+    }
+
+    const juce::ScopedLock sl(controlLock);
+
+    Message message;
+    message.opcode = bridgeSetProcessLevel;
+    message.value = level;
+
+    callControl(message);
+}
+
+void BridgeClient::resetRoundTripStats() {
+    lastOverhead.store(0.0);
+    averageOverhead.store(0.0);
+    maxOverhead.store(0.0);
+    numCalls.store(0);
+    numOverBudget.store(0);
+}
+
+void BridgeClient::recordRoundTrip(double totalMicroseconds, double serverMicroseconds) {
+    double overhead = juce::jmax(0.0, totalMicroseconds - serverMicroseconds);
+    auto calls = numCalls.load(std::memory_order_relaxed) + 1;
+
+    lastOverhead.store(overhead, std::memory_order_relaxed);
+    averageOverhead.store(averageOverhead.load(std::memory_order_relaxed)
+                          + (overhead - averageOverhead.load(std::memory_order_relaxed)) / (double)juce::jmin(calls, (juce::int64)1000),
+                          std::memory_order_relaxed);
+
+    if (overhead > maxOverhead.load(std::memory_order_relaxed)) {
+        maxOverhead.store(overhead, std::memory_order_relaxed);
+    }
+
+    if (overhead > roundTripBudgetMicroseconds) {
+        numOverBudget.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    numCalls.store(calls, std::memory_order_relaxed);
+}
+
+BridgeClient::RoundTripStats BridgeClient::getRoundTripStats() const {
+    RoundTripStats stats;
+    stats.lastMicroseconds = lastOverhead.load(std::memory_order_relaxed);
+    stats.averageMicroseconds = averageOverhead.load(std::memory_order_relaxed);
+    stats.maxMicroseconds = maxOverhead.load(std::memory_order_relaxed);
+    stats.numCalls = numCalls.load(std::memory_order_relaxed);
+    stats.numOverBudget = numOverBudget.load(std::memory_order_relaxed);
+    return stats;
+}
+
+//==============================================================================
+// Proxy AEffect callbacks
+
+VstIntPtr BridgeClient::proxyDispatcher(AEffect* effect, VstInt32 opcode, VstInt32 index, VstIntPtr value, void* ptr, float opt) {
+    return static_cast<BridgeClient*>(effect->object)->dispatch(opcode, index, value, ptr, opt);
+}
+
+void BridgeClient::proxyProcessReplacing(AEffect* effect, float** inputs, float** outputs, VstInt32 sampleFrames) {
+    static_cast<BridgeClient*>(effect->object)->process(inputs, outputs, sampleFrames);
+}
+
+void BridgeClient::proxySetParameter(AEffect* effect, VstInt32 index, float value) {
+    static_cast<BridgeClient*>(effect->object)->setParameter(index, value);
+}
+
+float BridgeClient::proxyGetParameter(AEffect* effect, VstInt32 index) {
+    return static_cast<BridgeClient*>(effect->object)->getParameter(index);
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BridgeIPC.h"
+
+// Wrapper side of the out-of-process engine bridge.
+//
+// AltiverbBridgeHost loads the VST2 plugin in its own process, so a crash in
+// the plugin cannot take the DAW down. One helper serves every wrapper
+// instance in the DAW; each instance gets its own shared-memory channel.
+
+// Process-wide connection to the helper, shared by every BridgeClient.
+// Launches AltiverbBridgeHost on first use and relaunches it if it died.
+class BridgeHostConnection {
+public:
+    BridgeHostConnection();
+    ~BridgeHostConnection();
+
+    bool attachChannel(const juce::String& channelName, const juce::String& pluginPath);
+    void detachChannel(const juce::String& channelName);
+
+    // Helper executable - defaults to AltiverbBridgeHost next to the wrapper binary
+    static juce::File getHelperExecutable();
+    static void setHelperExecutable(const juce::File& executable);
+
+private:
+    juce::CriticalSection lock;
+    juce::ChildProcess helper;
+    SharedMemoryRegion session;
+    BridgeProtocol::SessionHeader* header = nullptr;
+    BridgeLaneEndpoint lane;
+    int launchCount = 0;
+
+    bool ensureHelperRunning();
+    bool callHelper(BridgeProtocol::Message& message, const juce::String& payload);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BridgeHostConnection)
+};
+
+// One bridged plugin instance. VST2Loader gets a proxy AEffect whose
+// dispatcher, process and parameter callbacks forward through the channel,
+// so the rest of the wrapper talks to it exactly as to an in-process plugin.
+class BridgeClient {
+public:
+    BridgeClient();
+    ~BridgeClient();
+
+    // Load the plugin in the helper; returns the proxy effect or nullptr
+    AEffect* attach(const juce::String& pluginPath);
+    void detach();
+
+    bool isAttached() const noexcept { return attached; }
+    bool isAlive() const noexcept { return alive.load(std::memory_order_acquire); }
+
+    // Round-trip cost of the bridge itself (excluding the engine's processing time)
+    struct RoundTripStats {
+        double lastMicroseconds = 0.0;
+        double averageMicroseconds = 0.0;
+        double maxMicroseconds = 0.0;
+        juce::int64 numCalls = 0;
+        juce::int64 numOverBudget = 0;
+    };
+    RoundTripStats getRoundTripStats() const;
+    void resetRoundTripStats();
+
+    // What the plugin is told when it asks for the process level (offline rendering)
+    void setProcessLevel(VstInt32 level);
+
+    static void setHelperExecutable(const juce::File& executable);
+
+private:
+    juce::SharedResourcePointer<BridgeHostConnection> connection;
+    SharedMemoryRegion channel;
+    BridgeProtocol::ChannelHeader* header = nullptr;
+    BridgeLaneEndpoint audioLane;
+    BridgeLaneEndpoint controlLane;
+    juce::String channelName;
+    int audioSlot = 0;
+
+    AEffect proxy;
+    bool attached = false;
+    std::atomic<bool> alive { false };
+
+    // Serialises dispatcher calls from different non-audio threads
+    juce::CriticalSection controlLock;
+    juce::SpinLock parameterLock;
+
+    // Parameter changes the full ring couldn't take: the newest value per parameter,
+    // moved into the ring before the next block. Later parameters are dropped.
+    static constexpr int maxOverflowParameters = 128;
+    std::atomic<float> overflowValues[maxOverflowParameters] {};
+    std::atomic<juce::uint64> overflowPending[maxOverflowParameters / 64] {};
+    std::atomic<bool> hasOverflow { false };
+
+    // Storage for pointers handed back to the caller (chunks, editor rect)
+    juce::MemoryBlock chunkStorage;
+    ERect editorRect {};
+
+    // Round-trip statistics (audio thread writes, any thread reads)
+    std::atomic<double> lastOverhead { 0.0 };
+    std::atomic<double> averageOverhead { 0.0 };
+    std::atomic<double> maxOverhead { 0.0 };
+    std::atomic<juce::int64> numCalls { 0 };
+    std::atomic<juce::int64> numOverBudget { 0 };
+
+    VstIntPtr dispatch(VstInt32 opcode, VstInt32 index, VstIntPtr value, void* ptr, float opt);
+    void process(float** inputs, float** outputs, VstInt32 sampleFrames);
+    void processPiece(float** inputs, float** outputs, int startSample, int numSamples);
+    void flushOverflowedParameters() noexcept;
+    void setParameter(VstInt32 index, float value);
+    float getParameter(VstInt32 index);
+
+    bool callControl(BridgeProtocol::Message& message);
+    void recordRoundTrip(double totalMicroseconds, double serverMicroseconds);
+    void markDead();
+
+    // Proxy AEffect callbacks
+    static VstIntPtr proxyDispatcher(AEffect* effect, VstInt32 opcode, VstInt32 index, VstIntPtr value, void* ptr, float opt);
+    static void proxyProcessReplacing(AEffect* effect, float** inputs, float** outputs, VstInt32 sampleFrames);
+    static void proxySetParameter(AEffect* effect, VstInt32 index, float value);
+    static float proxyGetParameter(AEffect* effect, VstInt32 index);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BridgeClient)
+};
@@ -0,0 +1,354 @@
+#include "BridgeIPC.h"
+
+#if JUCE_WINDOWS
+  #include <Windows.h>
+#else
+  #include <cerrno>
+  #include <climits>
+  #include <ctime>
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  #if JUCE_LINUX
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+  #endif
+#endif
+
+//==============================================================================
+// SharedMemoryRegion
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    close();
+}
+
+#if JUCE_WINDOWS
+
+static bool mapRegion(const juce::String& name, size_t size, bool create, void*& mapping, void*& data) {
+    juce::String mappingName = "Local\\" + name;
+
+    if (create) {
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                     (DWORD)((uint64_t)size >> 32), (DWORD)(size & 0xffffffff),
+                                     mappingName.toRawUTF8());
+    } else {
+        mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mappingName.toRawUTF8());
+    }
+
+    if (!mapping) {
+        return false;
+    }
+
+    data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!data) {
+        CloseHandle(mapping);
+        mapping = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+bool SharedMemoryRegion::create(const juce::String& name, size_t size) {
+    close();
+
+    if (!mapRegion(name, size, true, mappingHandle, data)) {
+        return false;
+    }
+
+    std::memset(data, 0, size);
+    segmentName = name;
+    dataSize = size;
+    isCreator = true;
+    return true;
+}
+
+bool SharedMemoryRegion::open(const juce::String& name, size_t size) {
+    close();
+
+    if (!mapRegion(name, size, false, mappingHandle, data)) {
+        return false;
+    }
+
+    segmentName = name;
+    dataSize = size;
+    isCreator = false;
+    return true;
+}
+
+void SharedMemoryRegion::close() {
+    if (data) {
+        UnmapViewOfFile(data);
+        data = nullptr;
+    }
+
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+
+    dataSize = 0;
+}
+
+#else
+
+static bool mapRegion(const juce::String& name, size_t size, bool create, void*& data) {
+    juce::String shmName = "/" + name;
+
+    int fd = create ? shm_open(shmName.toRawUTF8(), O_CREAT | O_RDWR | O_TRUNC, 0600)
+                    : shm_open(shmName.toRawUTF8(), O_RDWR, 0600);
+    if (fd < 0) {
+        return false;
+    }
+
+    if (create && ftruncate(fd, (off_t)size) != 0) {
+        ::close(fd);
+        shm_unlink(shmName.toRawUTF8());
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (mapped == MAP_FAILED) {
+        if (create) {
+            shm_unlink(shmName.toRawUTF8());
+        }
+        return false;
+    }
+
+    data = mapped;
+    return true;
+}
+
+bool SharedMemoryRegion::create(const juce::String& name, size_t size) {
+    close();
+
+    // ftruncate already zero-fills the new segment
+    if (!mapRegion(name, size, true, data)) {
+        return false;
+    }
+
+    segmentName = name;
+    dataSize = size;
+    isCreator = true;
+    return true;
+}
+
+bool SharedMemoryRegion::open(const juce::String& name, size_t size) {
+    close();
+
+    if (!mapRegion(name, size, false, data)) {
+        return false;
+    }
+
+    segmentName = name;
+    dataSize = size;
+    isCreator = false;
+    return true;
+}
+
+void SharedMemoryRegion::close() {
+    if (data) {
+        munmap(data, dataSize);
+        data = nullptr;
+    }
+
+    if (isCreator && segmentName.isNotEmpty()) {
+        shm_unlink(("/" + segmentName).toRawUTF8());
+    }
+
+    isCreator = false;
+    dataSize = 0;
+}
+
+#endif
+
+//==============================================================================
+// BridgeSignal
+
+BridgeSignal::~BridgeSignal() {
+    close();
+}
+
+#if JUCE_WINDOWS
+
+bool BridgeSignal::open(const juce::String& name, std::atomic<uint32_t>* sequenceWord) {
+    close();
+
+    word = sequenceWord;
+
+    // Auto-reset event: a notify that races ahead of the wait stays signalled
+    juce::String eventName = "Local\\" + name;
+    eventHandle = CreateEventA(nullptr, FALSE, FALSE, eventName.toRawUTF8());
+    return eventHandle != nullptr;
+}
+
+void BridgeSignal::close() {
+    if (eventHandle) {
+        CloseHandle(eventHandle);
+        eventHandle = nullptr;
+    }
+    word = nullptr;
+}
+
+void BridgeSignal::notify() {
+    if (eventHandle) {
+        SetEvent(eventHandle);
+    }
+}
+
+bool BridgeSignal::waitWhileEquals(uint32_t seenValue, int timeoutMs) {
+    if (word->load(std::memory_order_acquire) != seenValue) {
+        return true;
+    }
+
+    WaitForSingleObject(eventHandle, (DWORD)timeoutMs);
+    return word->load(std::memory_order_acquire) != seenValue;
+}
+
+#else
+
+bool BridgeSignal::open(const juce::String&, std::atomic<uint32_t>* sequenceWord) {
+    word = sequenceWord;
+    return word != nullptr;
+}
+
+void BridgeSignal::close() {
+    word = nullptr;
+}
+
+void BridgeSignal::notify() {
+    #if JUCE_LINUX
+    // Shared (non-private) futex so waiters in the other process are woken
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    #endif
+}
+
+bool BridgeSignal::waitWhileEquals(uint32_t seenValue, int timeoutMs) {
+    if (word->load(std::memory_order_acquire) != seenValue) {
+        return true;
+    }
+
+    #if JUCE_LINUX
+    timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = (long)(timeoutMs % 1000) * 1000000L;
+
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, seenValue, &timeout, nullptr, 0);
+    #else
+    // No futex here - poll with short sleeps
+    for (int waited = 0; waited < timeoutMs && word->load(std::memory_order_acquire) == seenValue; ++waited) {
+        usleep(1000);
+    }
+    #endif
+
+    return word->load(std::memory_order_acquire) != seenValue;
+}
+
+#endif
+
+//==============================================================================
+// BridgeLaneEndpoint
+
+bool BridgeLaneEndpoint::open(BridgeProtocol::Lane* laneToUse, const juce::String& name) {
+    lane = laneToUse;
+
+    return requestSignal.open(name + "_req", &lane->requestSequence)
+        && responseSignal.open(name + "_resp", &lane->responseSequence);
+}
+
+void BridgeLaneEndpoint::close() {
+    requestSignal.close();
+    responseSignal.close();
+    lane = nullptr;
+}
+
+bool BridgeLaneEndpoint::call(const BridgeProtocol::Message& request, BridgeProtocol::Message& response, int timeoutMs) {
+    if (!lane) {
+        return false;
+    }
+    
+    BridgeProtocol::Message sequenced = request;
+    sequenced.sequence = ++nextSequence;
+    
+    if (!lane->requests.push(sequenced)) {
+        return false;
+    }
+    
+    lane->requestSequence.fetch_add(1, std::memory_order_release);
+    requestSignal.notify();
+    
+    // Responses to earlier calls that timed out are dropped here
+    auto popMatching = [&] {
+        while (lane->responses.pop(response)) {
+            if (response.sequence == sequenced.sequence) {
+                return true;
+            }
+        }
+        return false;
+    };
+    
+    // Spin first - a warm server answers within a few microseconds
+    for (int i = 0; i < spinIterations; ++i) {
+        if (popMatching()) {
+            return true;
+        }
+    }
+    
+    auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32)timeoutMs;
+    
+    for (;;) {
+        uint32_t seen = lane->responseSequence.load(std::memory_order_acquire);
+        
+        if (popMatching()) {
+            return true;
+        }
+        
+        auto now = juce::Time::getMillisecondCounter();
+        if (now >= deadline) {
+            return false;
+        }
+        
+        responseSignal.waitWhileEquals(seen, (int)(deadline - now));
+    }
+}
+
+bool BridgeLaneEndpoint::waitForRequest(BridgeProtocol::Message& request, int timeoutMs) {
+    if (!lane) {
+        return false;
+    }
+
+    for (int i = 0; i < spinIterations; ++i) {
+        if (lane->requests.pop(request)) {
+            return true;
+        }
+    }
+
+    uint32_t seen = lane->requestSequence.load(std::memory_order_acquire);
+
+    if (lane->requests.pop(request)) {
+        return true;
+    }
+
+    requestSignal.waitWhileEquals(seen, timeoutMs);
+    return lane->requests.pop(request);
+}
+
+void BridgeLaneEndpoint::respond(const BridgeProtocol::Message& response) {
+    if (!lane) {
+        return;
+    }
+
+    lane->responses.push(response);
+    lane->responseSequence.fetch_add(1, std::memory_order_release);
+    responseSignal.notify();
+}
+
+void BridgeLaneEndpoint::wakeServer() {
+    if (lane) {
+        lane->requestSequence.fetch_add(1, std::memory_order_release);
+        requestSignal.notify();
+    }
+}
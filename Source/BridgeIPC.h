@@ -0,0 +1,84 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BridgeProtocol.h"
+
+// Named shared memory segment (file mapping on Windows, shm_open on POSIX)
+class SharedMemoryRegion {
+public:
+    SharedMemoryRegion() = default;
+    ~SharedMemoryRegion();
+
+    bool create(const juce::String& name, size_t size);  // Creator owns and unlinks the name
+    bool open(const juce::String& name, size_t size);
+    void close();
+
+    void* getData() const noexcept { return data; }
+    bool isOpen() const noexcept { return data != nullptr; }
+
+private:
+    juce::String segmentName;
+    void* data = nullptr;
+    size_t dataSize = 0;
+    bool isCreator = false;
+
+    #if JUCE_WINDOWS
+    void* mappingHandle = nullptr;
+    #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedMemoryRegion)
+};
+
+// Wakes a waiter in another process when a shared sequence counter changes.
+// Linux waits on the counter itself with a futex, Windows uses a named event.
+class BridgeSignal {
+public:
+    BridgeSignal() = default;
+    ~BridgeSignal();
+
+    bool open(const juce::String& name, std::atomic<uint32_t>* sequenceWord);
+    void close();
+
+    void notify();
+
+    // Returns true once the counter differs from seenValue, false on timeout
+    bool waitWhileEquals(uint32_t seenValue, int timeoutMs);
+
+private:
+    std::atomic<uint32_t>* word = nullptr;
+
+    #if JUCE_WINDOWS
+    void* eventHandle = nullptr;
+    #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BridgeSignal)
+};
+
+// One side of a BridgeProtocol::Lane with both of its signals
+class BridgeLaneEndpoint {
+public:
+    BridgeLaneEndpoint() = default;
+
+    bool open(BridgeProtocol::Lane* lane, const juce::String& name);
+    void close();
+
+    // Client side: post a request and wait for its response
+    bool call(const BridgeProtocol::Message& request, BridgeProtocol::Message& response, int timeoutMs);
+
+    // Server side - responses must carry the request's sequence
+    bool waitForRequest(BridgeProtocol::Message& request, int timeoutMs);
+    void respond(const BridgeProtocol::Message& response);
+
+    // Wake a server blocked in waitForRequest (used for shutdown)
+    void wakeServer();
+
+private:
+    BridgeProtocol::Lane* lane = nullptr;
+    uint32_t nextSequence = 0;
+    BridgeSignal requestSignal;
+    BridgeSignal responseSignal;
+
+    // Spin briefly before sleeping in the kernel - most round trips finish within it
+    static constexpr int spinIterations = 2000;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BridgeLaneEndpoint)
+};
@@ -0,0 +1,215 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "VST2Types.h"
+
+// Shared-memory layout used between the wrapper and AltiverbBridgeHost.
+// Everything in here lives inside a mapped segment, so it must stay
+// plain data plus address-free atomics - no pointers, no JUCE types.
+namespace BridgeProtocol {
+
+constexpr uint32_t magic = 0x52425641;  // 'AVBR'
+constexpr uint32_t version = 3;
+
+constexpr int maxChannels = 12;          // Up to 7.1.4
+constexpr int maxBlockSize = 4096;       // Larger blocks are sent in pieces
+constexpr int audioSlots = 4;            // Depth of the audio ring
+constexpr int messageSlots = 16;
+constexpr size_t payloadCapacity = 4 * 1024 * 1024;  // Chunks, strings, arrangements
+
+// Bridge overhead allowed per audio round trip (on top of the engine's own time)
+constexpr double roundTripBudgetMicroseconds = 100.0;
+
+// Timeouts
+constexpr int audioTimeoutMs = 250;
+constexpr int controlTimeoutMs = 30000;  // Altiverb can take a while to load IRs
+constexpr int helperStartupTimeoutMs = 10000;
+
+// Opcodes that are not VST2 dispatcher opcodes (VST2 opcodes are all >= 0)
+enum BridgeOpcode : int32_t {
+    bridgeProcess = -1,
+    bridgeSetParameter = -2,
+    bridgeGetParameter = -3,
+    bridgeAttach = -4,
+    bridgeDetach = -5,
+    bridgeShutdown = -6,
+    bridgeSetProcessLevel = -7   // value = VstProcessLevels, answered by the helper's host callback
+};
+
+enum ServerState : uint32_t {
+    serverStarting = 0,
+    serverReady = 1,
+    serverFailed = 2,
+    serverClosed = 3
+};
+
+// Fixed-size message exchanged through the rings
+struct Message {
+    uint32_t sequence = 0;      // Echoed in the response so late answers can be discarded
+    int32_t opcode = 0;
+    int32_t index = 0;
+    int64_t value = 0;
+    float opt = 0.0f;
+    int32_t payloadSize = 0;    // Bytes used in the channel payload area
+    int64_t result = 0;
+    double serverMicroseconds = 0.0;
+};
+
+// Single-producer/single-consumer ring, safe across processes
+template <typename T, int Capacity>
+struct SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    std::atomic<uint32_t> head;  // Written by producer
+    std::atomic<uint32_t> tail;  // Written by consumer
+    T items[Capacity];
+
+    void reset() noexcept {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    bool push(const T& item) noexcept {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= (uint32_t)Capacity) {
+            return false;
+        }
+        items[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) noexcept {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// One request/response lane. Each sequence counter doubles as the futex
+// word (Linux) or the value checked before waiting on a named event (Windows).
+struct Lane {
+    std::atomic<uint32_t> requestSequence;
+    std::atomic<uint32_t> responseSequence;
+    SpscRing<Message, messageSlots> requests;
+    SpscRing<Message, messageSlots> responses;
+
+    void reset() noexcept {
+        requestSequence.store(0, std::memory_order_relaxed);
+        responseSequence.store(0, std::memory_order_relaxed);
+        requests.reset();
+        responses.reset();
+    }
+};
+
+// Effect description published by the host after loading the plugin
+struct EffectInfo {
+    int32_t numPrograms;
+    int32_t numParams;
+    int32_t numInputs;
+    int32_t numOutputs;
+    int32_t flags;
+    int32_t initialDelay;
+    int32_t uniqueID;
+    int32_t version;
+};
+
+// Per wrapper instance segment: header, payload area, then the audio ring
+struct ChannelHeader {
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> serverState;
+    EffectInfo effectInfo;
+    Lane audioLane;       // Audio thread only
+    Lane controlLane;     // Dispatcher calls from the message thread
+    SpscRing<Message, 256> parameterRing;  // Fire-and-forget setParameter, drained by the audio lane before each block
+};
+
+// Helper-wide segment used to attach and detach channels
+struct SessionHeader {
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> serverState;
+    Lane lane;
+};
+
+// How the dispatcher's ptr/value arguments travel through the payload area
+enum class PointerKind {
+    none,                  // ptr unused
+    stringOut,             // Plugin writes a C string into ptr
+    stringIn,              // ptr is a C string
+    chunkOut,              // ptr receives a pointer to plugin-owned data, result is its size
+    chunkIn,               // ptr is value bytes of host data
+    speakerArrangements,   // value and ptr each point to a VstSpeakerArrangement (in/out)
+    editorRectOut,         // ptr receives a pointer to a plugin-owned ERect
+    windowHandle           // ptr is a native window handle, sent by value
+};
+
+constexpr int maxStringLength = 256;  // Matches the buffers VST2Loader passes
+
+inline PointerKind getPointerKind(int32_t opcode) noexcept {
+    switch (opcode) {
+        case effGetProgramName:
+        case effGetProgramNameIndexed:
+        case effGetParamLabel:
+        case effGetParamDisplay:
+        case effGetParamName:
+            return PointerKind::stringOut;
+            
+        case effSetProgramName:
+        case effCanDo:
+            return PointerKind::stringIn;
+            
+        case effGetChunk:
+            return PointerKind::chunkOut;
+            
+        case effSetChunk:
+            return PointerKind::chunkIn;
+            
+        case effSetSpeakerArrangement:
+        case effGetSpeakerArrangement:
+            return PointerKind::speakerArrangements;
+            
+        case effEditGetRect:
+            return PointerKind::editorRectOut;
+            
+        case effEditOpen:
+            return PointerKind::windowHandle;
+            
+        default:
+            return PointerKind::none;
+    }
+}
+
+constexpr size_t alignUp(size_t numBytes) noexcept {
+    return (numBytes + 63) & ~(size_t)63;
+}
+
+constexpr size_t channelPayloadOffset = alignUp(sizeof(ChannelHeader));
+constexpr size_t channelAudioOffset = channelPayloadOffset + payloadCapacity;
+constexpr size_t audioSlotFloats = (size_t)2 * maxChannels * maxBlockSize;  // Inputs then outputs
+constexpr size_t channelSegmentSize = channelAudioOffset + audioSlots * audioSlotFloats * sizeof(float);
+
+constexpr size_t sessionPayloadCapacity = 4096;
+constexpr size_t sessionPayloadOffset = alignUp(sizeof(SessionHeader));
+constexpr size_t sessionSegmentSize = sessionPayloadOffset + sessionPayloadCapacity;
+
+inline char* getPayload(void* segment) noexcept {
+    return static_cast<char*>(segment) + channelPayloadOffset;
+}
+
+inline float* getAudioChannel(void* segment, int slot, bool isOutput, int channel) noexcept {
+    float* audio = reinterpret_cast<float*>(static_cast<char*>(segment) + channelAudioOffset);
+    return audio + (size_t)slot * audioSlotFloats
+                 + (size_t)(isOutput ? maxChannels : 0) * maxBlockSize
+                 + (size_t)channel * maxBlockSize;
+}
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Bridge atomics must be lock-free to work across processes");
+
+} // namespace BridgeProtocol
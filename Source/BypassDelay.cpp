@@ -0,0 +1,149 @@
+#include "BypassDelay.h"
+
+void BypassDelay::reserve(ScratchArena& arena, int channels, int maxDelay, int blockSize) {
+    numChannels = juce::jlimit(0, maxChannels, channels);
+    maxBlockSize = juce::jmax(1, blockSize);
+    toFloat = ChannelKernels::getToFloatKernel();
+    toDouble = ChannelKernels::getToDoubleKernel();
+
+    // Host blocks may run a little over the prepared size - leave room for two
+    capacity = juce::nextPowerOfTwo(juce::jmax(0, maxDelay) + 2 * maxBlockSize);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        ringOffsets[ch] = arena.reserveArray<float>((size_t)capacity);
+    }
+}
+
+void BypassDelay::attach(const ScratchArena& arena) {
+    for (int ch = 0; ch < maxChannels; ++ch) {
+        rings[ch] = ch < numChannels ? arena.getArray<float>(ringOffsets[ch]) : nullptr;
+    }
+
+    reset();
+}
+
+void BypassDelay::reset() {
+    writePosition = 0;
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        juce::FloatVectorOperations::clear(rings[ch], capacity);
+    }
+}
+
+void BypassDelay::setDelay(int numSamples) noexcept {
+    delay.store(juce::jlimit(0, juce::jmax(0, capacity - 2 * maxBlockSize), numSamples), std::memory_order_relaxed);
+}
+
+int BypassDelay::getReadPosition(int numSamples) const noexcept {
+    const int effectiveDelay = juce::jmin(getDelay(), capacity - numSamples);
+    return (writePosition - numSamples - effectiveDelay) & (capacity - 1);
+}
+
+void BypassDelay::push(const juce::AudioBuffer<float>& buffer) noexcept {
+    const int numSamples = buffer.getNumSamples();
+    if (capacity == 0 || numSamples > capacity) {
+        return;
+    }
+
+    const int firstPart = juce::jmin(numSamples, capacity - writePosition);
+
+    for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch) {
+        const float* input = buffer.getReadPointer(ch);
+        juce::FloatVectorOperations::copy(rings[ch] + writePosition, input, firstPart);
+        juce::FloatVectorOperations::copy(rings[ch], input + firstPart, numSamples - firstPart);
+    }
+
+    writePosition = (writePosition + numSamples) & (capacity - 1);
+}
+
+void BypassDelay::readDelayed(juce::AudioBuffer<float>& buffer) noexcept {
+    const int numSamples = buffer.getNumSamples();
+    if (capacity == 0 || numSamples > capacity) {
+        return;
+    }
+
+    const int readPosition = getReadPosition(numSamples);
+    const int firstPart = juce::jmin(numSamples, capacity - readPosition);
+
+    for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch) {
+        float* output = buffer.getWritePointer(ch);
+        juce::FloatVectorOperations::copy(output, rings[ch] + readPosition, firstPart);
+        juce::FloatVectorOperations::copy(output + firstPart, rings[ch], numSamples - firstPart);
+    }
+}
+
+void BypassDelay::mixDelayed(juce::AudioBuffer<float>& buffer, float startDryGain, float endDryGain) noexcept {
+    const int numSamples = buffer.getNumSamples();
+    if (capacity == 0 || numSamples == 0 || numSamples > capacity) {
+        return;
+    }
+
+    const int readPosition = getReadPosition(numSamples);
+    const int firstPart = juce::jmin(numSamples, capacity - readPosition);
+    const float splitGain = startDryGain + (endDryGain - startDryGain) * (float)firstPart / (float)numSamples;
+
+    for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch) {
+        buffer.applyGainRamp(ch, 0, numSamples, 1.0f - startDryGain, 1.0f - endDryGain);
+        buffer.addFromWithRamp(ch, 0, rings[ch] + readPosition, firstPart, startDryGain, splitGain);
+
+        if (firstPart < numSamples) {
+            buffer.addFromWithRamp(ch, firstPart, rings[ch], numSamples - firstPart, splitGain, endDryGain);
+        }
+    }
+}
+
+void BypassDelay::push(const juce::AudioBuffer<double>& buffer) noexcept {
+    const int numSamples = buffer.getNumSamples();
+    if (capacity == 0 || numSamples > capacity) {
+        return;
+    }
+
+    const int firstPart = juce::jmin(numSamples, capacity - writePosition);
+
+    for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch) {
+        const double* input = buffer.getReadPointer(ch);
+        toFloat(rings[ch] + writePosition, input, firstPart);
+        toFloat(rings[ch], input + firstPart, numSamples - firstPart);
+    }
+
+    writePosition = (writePosition + numSamples) & (capacity - 1);
+}
+
+void BypassDelay::readDelayed(juce::AudioBuffer<double>& buffer) noexcept {
+    const int numSamples = buffer.getNumSamples();
+    if (capacity == 0 || numSamples > capacity) {
+        return;
+    }
+
+    const int readPosition = getReadPosition(numSamples);
+    const int firstPart = juce::jmin(numSamples, capacity - readPosition);
+
+    for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch) {
+        double* output = buffer.getWritePointer(ch);
+        toDouble(output, rings[ch] + readPosition, firstPart);
+        toDouble(output + firstPart, rings[ch], numSamples - firstPart);
+    }
+}
+
+void BypassDelay::mixDelayed(juce::AudioBuffer<double>& buffer, float startDryGain, float endDryGain) noexcept {
+    const int numSamples = buffer.getNumSamples();
+    if (capacity == 0 || numSamples == 0 || numSamples > capacity) {
+        return;
+    }
+
+    // Only runs for the few blocks of a fade - a plain loop does
+    const int readPosition = getReadPosition(numSamples);
+    const double step = ((double)endDryGain - (double)startDryGain) / (double)numSamples;
+
+    for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch) {
+        double* output = buffer.getWritePointer(ch);
+        const float* ring = rings[ch];
+        double dryGain = startDryGain;
+
+        for (int i = 0; i < numSamples; ++i) {
+            const double dry = ring[(readPosition + i) & (capacity - 1)];
+            output[i] = output[i] * (1.0 - dryGain) + dry * dryGain;
+            dryGain += step;
+        }
+    }
+}
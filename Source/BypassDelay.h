@@ -0,0 +1,64 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include "ScratchArena.h"
+#include "ChannelKernels.h"
+
+// Dry signal for bypass, delayed by the latency the wrapper reports.
+//
+// Every host block is pushed in, bypassed or not, so the delayed dry signal
+// lines up with the engine's output at any moment. That lets bypass switch
+// with a short crossfade instead of a jump in level or timing. The ring
+// lives in the processor's scratch arena, so the audio thread never allocates.
+class BypassDelay {
+public:
+    static constexpr int maxChannels = 12;  // Up to 7.1.4
+
+    // Room for plugin latency not yet known when preparing (engine still loading)
+    static constexpr int defaultMaxDelay = 8192;
+
+    BypassDelay() = default;
+
+    // Preparation (message thread) - reserve() before the arena is allocated, attach() after.
+    // Blocks up to blockSize keep the full delay; the owner splits larger host blocks.
+    void reserve(ScratchArena& arena, int numChannels, int maxDelay, int blockSize);
+    void attach(const ScratchArena& arena);
+    void reset();
+
+    // Any thread - clamped to what the ring can hold
+    void setDelay(int numSamples) noexcept;
+    int getDelay() const noexcept { return delay.load(std::memory_order_relaxed); }
+
+    // Audio thread: store the block's input before anything overwrites the buffer
+    void push(const juce::AudioBuffer<float>& buffer) noexcept;
+
+    // Audio thread: replace the block with the delayed input of the block just pushed
+    void readDelayed(juce::AudioBuffer<float>& buffer) noexcept;
+
+    // Audio thread: blend in the delayed input, its gain ramping from startDryGain
+    // to endDryGain across the block while the buffer's own signal takes the rest
+    void mixDelayed(juce::AudioBuffer<float>& buffer, float startDryGain, float endDryGain) noexcept;
+
+    // Double-precision hosts - the ring stays float, converted on the way in and out
+    void push(const juce::AudioBuffer<double>& buffer) noexcept;
+    void readDelayed(juce::AudioBuffer<double>& buffer) noexcept;
+    void mixDelayed(juce::AudioBuffer<double>& buffer, float startDryGain, float endDryGain) noexcept;
+
+private:
+    int numChannels = 0;
+    int capacity = 0;        // Power of two
+    int maxBlockSize = 0;
+    int writePosition = 0;
+    std::atomic<int> delay { 0 };
+
+    float* rings[maxChannels] = {};
+    size_t ringOffsets[maxChannels] = {};
+
+    ChannelKernels::ToFloatFn toFloat = nullptr;
+    ChannelKernels::ToDoubleFn toDouble = nullptr;
+
+    // Ring index of the delayed sample for the first sample of the last pushed block
+    int getReadPosition(int numSamples) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BypassDelay)
+};
@@ -0,0 +1,151 @@
+#include "ChannelKernels.h"
+
+#if JUCE_INTEL
+#include <immintrin.h>
+#endif
+
+namespace ChannelKernels {
+
+namespace {
+
+#if JUCE_INTEL
+// Part of x64, so always there
+void gainCopySse2(float* destination, const float* source, float gain, int numSamples) {
+    const __m128 gains = _mm_set1_ps(gain);
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm_storeu_ps(destination + i, _mm_mul_ps(_mm_loadu_ps(source + i), gains));
+        _mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_loadu_ps(source + i + 4), gains));
+    }
+
+    for (; i < numSamples; ++i) {
+        destination[i] = source[i] * gain;
+    }
+}
+
+// Built for AVX2 on its own, so the rest of the plugin still runs on older CPUs
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+void gainCopyAvx2(float* destination, const float* source, float gain, int numSamples) {
+    const __m256 gains = _mm256_set1_ps(gain);
+    int i = 0;
+
+    for (; i + 16 <= numSamples; i += 16) {
+        _mm256_storeu_ps(destination + i, _mm256_mul_ps(_mm256_loadu_ps(source + i), gains));
+        _mm256_storeu_ps(destination + i + 8, _mm256_mul_ps(_mm256_loadu_ps(source + i + 8), gains));
+    }
+
+    for (; i < numSamples; ++i) {
+        destination[i] = source[i] * gain;
+    }
+}
+
+void toFloatSse2(float* destination, const double* source, int numSamples) {
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4) {
+        const __m128 low = _mm_cvtpd_ps(_mm_loadu_pd(source + i));
+        const __m128 high = _mm_cvtpd_ps(_mm_loadu_pd(source + i + 2));
+        _mm_storeu_ps(destination + i, _mm_movelh_ps(low, high));
+    }
+
+    for (; i < numSamples; ++i) {
+        destination[i] = (float)source[i];
+    }
+}
+
+void toDoubleSse2(double* destination, const float* source, int numSamples) {
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4) {
+        const __m128 samples = _mm_loadu_ps(source + i);
+        _mm_storeu_pd(destination + i, _mm_cvtps_pd(samples));
+        _mm_storeu_pd(destination + i + 2, _mm_cvtps_pd(_mm_movehl_ps(samples, samples)));
+    }
+
+    for (; i < numSamples; ++i) {
+        destination[i] = (double)source[i];
+    }
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+void toFloatAvx2(float* destination, const double* source, int numSamples) {
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm_storeu_ps(destination + i, _mm256_cvtpd_ps(_mm256_loadu_pd(source + i)));
+        _mm_storeu_ps(destination + i + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(source + i + 4)));
+    }
+
+    for (; i < numSamples; ++i) {
+        destination[i] = (float)source[i];
+    }
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("avx2")))
+#endif
+void toDoubleAvx2(double* destination, const float* source, int numSamples) {
+    int i = 0;
+
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm256_storeu_pd(destination + i, _mm256_cvtps_pd(_mm_loadu_ps(source + i)));
+        _mm256_storeu_pd(destination + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(source + i + 4)));
+    }
+
+    for (; i < numSamples; ++i) {
+        destination[i] = (double)source[i];
+    }
+}
+#else
+void gainCopyPortable(float* destination, const float* source, float gain, int numSamples) {
+    juce::FloatVectorOperations::copyWithMultiply(destination, source, gain, numSamples);
+}
+
+void toFloatPortable(float* destination, const double* source, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        destination[i] = (float)source[i];
+    }
+}
+
+void toDoublePortable(double* destination, const float* source, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        destination[i] = (double)source[i];
+    }
+}
+#endif
+
+} // namespace
+
+GainCopyFn getGainCopyKernel() {
+    #if JUCE_INTEL
+    static const GainCopyFn kernel = juce::SystemStats::hasAVX2() ? &gainCopyAvx2 : &gainCopySse2;
+    return kernel;
+    #else
+    return &gainCopyPortable;
+    #endif
+}
+
+ToFloatFn getToFloatKernel() {
+    #if JUCE_INTEL
+    static const ToFloatFn kernel = juce::SystemStats::hasAVX2() ? &toFloatAvx2 : &toFloatSse2;
+    return kernel;
+    #else
+    return &toFloatPortable;
+    #endif
+}
+
+ToDoubleFn getToDoubleKernel() {
+    #if JUCE_INTEL
+    static const ToDoubleFn kernel = juce::SystemStats::hasAVX2() ? &toDoubleAvx2 : &toDoubleSse2;
+    return kernel;
+    #else
+    return &toDoublePortable;
+    #endif
+}
+
+} // namespace ChannelKernels
@@ -0,0 +1,53 @@
+#pragma once
+#include <JuceHeader.h>
+#include <utility>
+
+// Channel copies unrolled at compile time, one kernel per layout size.
+//
+// Routing between host and plugin order happens on the pointer tables, so a
+// chunk only needs N straight copies. With N a template argument the copies
+// come out as a fixed sequence with no channel loop or bounds checks.
+//
+// The gain copy is for the routing matrix: trim and polarity are applied
+// while copying, in a single pass, with the widest vectors the CPU has. The
+// conversions serve hosts running in double precision when Altiverb itself
+// only processes floats.
+namespace ChannelKernels {
+
+using CopyFn = void (*)(float* const* destinations, const float* const* sources, int numSamples);
+
+template <int... Channels>
+inline void copyChannels(float* const* destinations, const float* const* sources, int numSamples,
+                         std::integer_sequence<int, Channels...>) {
+    (juce::FloatVectorOperations::copy(destinations[Channels], sources[Channels], numSamples), ...);
+}
+
+template <int NumChannels>
+void copy(float* const* destinations, const float* const* sources, int numSamples) {
+    copyChannels(destinations, sources, numSamples, std::make_integer_sequence<int, NumChannels>());
+}
+
+// Null for channel counts no layout uses
+inline CopyFn getCopyKernel(int numChannels) {
+    switch (numChannels) {
+        case 6:  return &copy<6>;
+        case 8:  return &copy<8>;
+        case 12: return &copy<12>;
+        default: return nullptr;
+    }
+}
+
+// destination = source * gain
+using GainCopyFn = void (*)(float* destination, const float* source, float gain, int numSamples);
+
+// AVX2, SSE2 or portable - checked once, the same for every call after
+GainCopyFn getGainCopyKernel();
+
+// Sample format conversion, dispatched the same way
+using ToFloatFn = void (*)(float* destination, const double* source, int numSamples);
+using ToDoubleFn = void (*)(double* destination, const float* source, int numSamples);
+
+ToFloatFn getToFloatKernel();
+ToDoubleFn getToDoubleKernel();
+
+} // namespace ChannelKernels
@@ -0,0 +1,58 @@
+#include "ChannelRouting.h"
+
+bool ChannelRouting::isPassThrough() const noexcept {
+    if (order != Order::standard) {
+        return false;
+    }
+
+    for (const auto& channel : channels) {
+        if (channel.inputTrimDb != 0.0f || channel.inputInverted
+            || channel.outputTrimDb != 0.0f || channel.outputInverted) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ChannelRouting::operator==(const ChannelRouting& other) const noexcept {
+    if (order != other.order) {
+        return false;
+    }
+
+    for (int ch = 0; ch < SpeakerLayout::maxChannels; ++ch) {
+        const auto& a = channels[ch];
+        const auto& b = other.channels[ch];
+
+        if (a.inputTrimDb != b.inputTrimDb || a.inputInverted != b.inputInverted
+            || a.outputTrimDb != b.outputTrimDb || a.outputInverted != b.outputInverted) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void RoutingMatrix::build(const ChannelRouting& routing, const SpeakerLayout& layout) {
+    numChannels = layout.numChannels;
+
+    for (int ch = 0; ch < SpeakerLayout::maxChannels; ++ch) {
+        inputs[ch] = Route();
+        outputs[ch] = Route();
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const auto& speaker = layout.speakers[ch];
+        const auto& channel = routing.channels[ch];
+        const int hostChannel = routing.order == ChannelRouting::Order::film ? speaker.filmChannel : speaker.hostChannel;
+
+        const float inputTrim = juce::jlimit(ChannelRouting::minTrimDb, ChannelRouting::maxTrimDb, channel.inputTrimDb);
+        const float outputTrim = juce::jlimit(ChannelRouting::minTrimDb, ChannelRouting::maxTrimDb, channel.outputTrimDb);
+
+        inputs[ch].source = hostChannel;
+        inputs[ch].gain = juce::Decibels::decibelsToGain(inputTrim) * (channel.inputInverted ? -1.0f : 1.0f);
+
+        outputs[hostChannel].source = ch;
+        outputs[hostChannel].gain = juce::Decibels::decibelsToGain(outputTrim) * (channel.outputInverted ? -1.0f : 1.0f);
+    }
+}
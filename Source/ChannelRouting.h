@@ -0,0 +1,45 @@
+#pragma once
+#include <JuceHeader.h>
+#include "SpeakerLayout.h"
+
+// Channel order, trim and polarity between the host and Altiverb, saved with
+// the project. Film order is for material laid out L C R, surrounds, LFE on a
+// track the host thinks is in its standard order.
+struct ChannelRouting {
+    enum class Order { standard, film };
+
+    static constexpr float minTrimDb = -24.0f;
+    static constexpr float maxTrimDb = 12.0f;
+
+    struct Channel {
+        float inputTrimDb = 0.0f;
+        bool inputInverted = false;
+        float outputTrimDb = 0.0f;
+        bool outputInverted = false;
+    };
+
+    Order order = Order::standard;
+    Channel channels[SpeakerLayout::maxChannels];  // Plugin order
+
+    // Standard order, no trim, no inversion - nothing to apply
+    bool isPassThrough() const noexcept;
+
+    bool operator==(const ChannelRouting& other) const noexcept;
+    bool operator!=(const ChannelRouting& other) const noexcept { return !(*this == other); }
+};
+
+// ChannelRouting resolved for one layout: where every channel comes from and
+// the gain it is copied with, polarity included. Built in prepareToPlay, read
+// by the audio thread.
+struct RoutingMatrix {
+    struct Route {
+        int source = -1;    // Channel on the other side, -1 = silence
+        float gain = 1.0f;
+    };
+
+    int numChannels = 0;
+    Route inputs[SpeakerLayout::maxChannels];   // Plugin channel <- host channel
+    Route outputs[SpeakerLayout::maxChannels];  // Host channel <- plugin channel
+
+    void build(const ChannelRouting& routing, const SpeakerLayout& layout);
+};
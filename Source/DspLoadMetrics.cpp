@@ -0,0 +1,125 @@
+#include "DspLoadMetrics.h"
+#include <cmath>
+
+void DspLoadMetrics::prepare(double sampleRate) {
+    secondsPerSample = 1.0 / juce::jmax(1.0, sampleRate);
+    secondsPerTick = juce::Time::highResolutionTicksToSeconds(1);
+    reset();
+}
+
+void DspLoadMetrics::clearCallsIfRequested() noexcept {
+    if (!callResetRequested.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+
+    numCalls.store(0, std::memory_order_relaxed);
+    maxCallMicroseconds.store(0.0, std::memory_order_relaxed);
+}
+
+void DspLoadMetrics::clearBlocksIfRequested() noexcept {
+    if (!blockResetRequested.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+
+    numBlocks.store(0, std::memory_order_relaxed);
+    numOverruns.store(0, std::memory_order_relaxed);
+    lastLoad.store(0.0, std::memory_order_relaxed);
+    peakLoad.store(0.0, std::memory_order_relaxed);
+    busySeconds.store(0.0, std::memory_order_relaxed);
+    audioSeconds.store(0.0, std::memory_order_relaxed);
+}
+
+void DspLoadMetrics::recordCall(juce::int64 elapsedTicks) noexcept {
+    clearCallsIfRequested();
+
+    const double microseconds = (double)elapsedTicks * secondsPerTick * 1.0e6;
+
+    int bucket = 0;
+    if (microseconds > 1.0) {
+        bucket = juce::jmin(numBuckets - 1, (int)(std::log2(microseconds) * bucketsPerOctave));
+    }
+
+    // Single writer - plain load/store pairs are enough and never wait
+    buckets[bucket].store(buckets[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    numCalls.store(numCalls.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+    if (microseconds > maxCallMicroseconds.load(std::memory_order_relaxed)) {
+        maxCallMicroseconds.store(microseconds, std::memory_order_relaxed);
+    }
+}
+
+void DspLoadMetrics::recordBlock(juce::int64 elapsedTicks, int numSamples) noexcept {
+    clearBlocksIfRequested();
+
+    if (numSamples <= 0) {
+        return;
+    }
+
+    const double busy = (double)elapsedTicks * secondsPerTick;
+    const double duration = (double)numSamples * secondsPerSample;
+    const double load = busy / duration;
+
+    lastLoad.store(load, std::memory_order_relaxed);
+    busySeconds.store(busySeconds.load(std::memory_order_relaxed) + busy, std::memory_order_relaxed);
+    audioSeconds.store(audioSeconds.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+
+    if (load > peakLoad.load(std::memory_order_relaxed)) {
+        peakLoad.store(load, std::memory_order_relaxed);
+    }
+
+    if (load > 1.0) {
+        numOverruns.store(numOverruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    numBlocks.store(numBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+double DspLoadMetrics::getBucketLimitMicroseconds(int bucket) noexcept {
+    return std::exp2((double)(bucket + 1) / bucketsPerOctave);
+}
+
+DspLoadMetrics::Snapshot DspLoadMetrics::getSnapshot() const {
+    Snapshot snapshot;
+    snapshot.numCalls = numCalls.load(std::memory_order_acquire);
+    snapshot.numBlocks = numBlocks.load(std::memory_order_acquire);
+    snapshot.numOverruns = numOverruns.load(std::memory_order_relaxed);
+    snapshot.lastLoad = lastLoad.load(std::memory_order_relaxed);
+    snapshot.peakLoad = peakLoad.load(std::memory_order_relaxed);
+    snapshot.maxCallMicroseconds = maxCallMicroseconds.load(std::memory_order_relaxed);
+
+    const double audio = audioSeconds.load(std::memory_order_relaxed);
+    if (audio > 0.0) {
+        snapshot.averageLoad = busySeconds.load(std::memory_order_relaxed) / audio;
+    }
+
+    // Percentiles from a copy of the histogram - it may be a few calls behind numCalls
+    juce::int64 counts[numBuckets];
+    juce::int64 total = 0;
+    for (int i = 0; i < numBuckets; ++i) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    auto percentile = [&](double fraction) {
+        const juce::int64 target = juce::jmax((juce::int64)1, (juce::int64)std::ceil(fraction * (double)total));
+        juce::int64 seen = 0;
+        for (int i = 0; i < numBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= target) {
+                return juce::jmin(getBucketLimitMicroseconds(i), snapshot.maxCallMicroseconds);
+            }
+        }
+        return snapshot.maxCallMicroseconds;
+    };
+
+    if (total > 0) {
+        snapshot.p50CallMicroseconds = percentile(0.50);
+        snapshot.p99CallMicroseconds = percentile(0.99);
+    }
+
+    return snapshot;
+}
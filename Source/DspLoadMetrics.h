@@ -0,0 +1,68 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+// Per-instance DSP load statistics.
+// Calls and blocks each have their own counters and one writer, which never
+// waits or allocates - the audio thread, or for calls the engine thread when
+// pipelined. Any thread can take a snapshot (editor timer, monitoring API).
+class DspLoadMetrics {
+public:
+    // Histogram of processReplacing call times, four buckets per octave from 1 us
+    static constexpr int bucketsPerOctave = 4;
+    static constexpr int numBuckets = 72;  // Up to ~260 ms
+
+    struct Snapshot {
+        juce::int64 numCalls = 0;        // processReplacing calls
+        juce::int64 numBlocks = 0;       // Host blocks
+        juce::int64 numOverruns = 0;     // Blocks that took longer than their own duration
+        double lastLoad = 0.0;           // Processing time / block duration, 1.0 = deadline
+        double averageLoad = 0.0;
+        double peakLoad = 0.0;
+        double p50CallMicroseconds = 0.0;
+        double p99CallMicroseconds = 0.0;
+        double maxCallMicroseconds = 0.0;
+    };
+
+    DspLoadMetrics() = default;
+
+    void prepare(double sampleRate);
+
+    // Audio thread
+    void recordCall(juce::int64 elapsedTicks) noexcept;
+    void recordBlock(juce::int64 elapsedTicks, int numSamples) noexcept;
+
+    // Any thread
+    Snapshot getSnapshot() const;
+    void reset() noexcept {
+        callResetRequested.store(true, std::memory_order_release);
+        blockResetRequested.store(true, std::memory_order_release);
+    }
+
+    // Upper edge of a histogram bucket in microseconds
+    static double getBucketLimitMicroseconds(int bucket) noexcept;
+
+private:
+    double secondsPerSample = 1.0 / 48000.0;
+    double secondsPerTick = 1.0e-9;
+
+    std::atomic<juce::int64> buckets[numBuckets] {};
+    std::atomic<juce::int64> numCalls { 0 };
+    std::atomic<juce::int64> numBlocks { 0 };
+    std::atomic<juce::int64> numOverruns { 0 };
+    std::atomic<double> maxCallMicroseconds { 0.0 };
+    std::atomic<double> lastLoad { 0.0 };
+    std::atomic<double> peakLoad { 0.0 };
+    std::atomic<double> busySeconds { 0.0 };
+    std::atomic<double> audioSeconds { 0.0 };
+
+    // Readers can't clear the counters themselves. Each writer clears only its
+    // own on its next record, so a reset never races the other writer.
+    std::atomic<bool> callResetRequested { false };
+    std::atomic<bool> blockResetRequested { false };
+
+    void clearCallsIfRequested() noexcept;
+    void clearBlocksIfRequested() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DspLoadMetrics)
+};
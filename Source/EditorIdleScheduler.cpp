@@ -0,0 +1,51 @@
+#include "EditorIdleScheduler.h"
+
+EditorIdleScheduler::~EditorIdleScheduler() {
+    stop();
+}
+
+void EditorIdleScheduler::start(AEffect* editorEffect, WindowStateFn windowState) {
+    effect = editorEffect;
+    getWindowState = std::move(windowState);
+    idleCostMs = 0.0;
+    numIdleCalls = 0;
+
+    if (effect != nullptr) {
+        startTimer(displayIntervalMs);
+    }
+}
+
+void EditorIdleScheduler::stop() {
+    stopTimer();
+    effect = nullptr;
+    getWindowState = nullptr;
+}
+
+int EditorIdleScheduler::step(WindowState state) {
+    if (effect == nullptr || state == WindowState::closed) {
+        return 0;
+    }
+
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+    effect->dispatcher(effect, effEditIdle, 0, 0, nullptr, 0.0f);
+    ++numIdleCalls;
+
+    const double elapsedMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+    idleCostMs += (elapsedMs - idleCostMs) * 0.25;
+
+    if (state != WindowState::visible) {
+        return backgroundIntervalMs;
+    }
+
+    return juce::jlimit(displayIntervalMs, maxIntervalMs, juce::roundToInt(idleCostMs * 4.0));
+}
+
+void EditorIdleScheduler::timerCallback() {
+    const int nextMs = step(getWindowState ? getWindowState() : WindowState::closed);
+
+    if (nextMs <= 0) {
+        stop();
+    } else if (nextMs != getTimerInterval()) {
+        startTimer(nextMs);
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <JuceHeader.h>
+#include <functional>
+#include "VST2Types.h"
+
+// Sends effEditIdle to an open VST2 editor from the message thread.
+//
+// While the window is visible the editor is idled at display rate; when it
+// is minimised or hidden only once a second, so it can keep its housekeeping
+// going without costing anything noticeable. An editor whose idle calls are
+// slow is idled less often, keeping its share of the message thread to about
+// a quarter instead of stalling the host's UI.
+//
+// step() holds all the scheduling decisions and takes the window state as an
+// argument, so it can be driven directly against a stub AEffect.
+class EditorIdleScheduler : private juce::Timer {
+public:
+    enum class WindowState { closed, hidden, minimised, visible };
+    using WindowStateFn = std::function<WindowState()>;
+
+    static constexpr int displayIntervalMs = 16;       // ~60 Hz while visible
+    static constexpr int backgroundIntervalMs = 1000;  // Hidden or minimised
+    static constexpr int maxIntervalMs = 100;          // Slow editors still get 10 Hz when visible
+
+    EditorIdleScheduler() = default;
+    ~EditorIdleScheduler() override;
+
+    // Message thread: idle the effect's editor until stop(), or until the window closes
+    void start(AEffect* editorEffect, WindowStateFn windowState);
+    void stop();
+    bool isRunning() const noexcept { return effect != nullptr; }
+
+    // One scheduling step: idles the editor if it is open and returns the delay
+    // until the next step, or 0 once the window has closed
+    int step(WindowState state);
+
+    int getNumIdleCalls() const noexcept { return numIdleCalls; }
+    double getIdleCostMilliseconds() const noexcept { return idleCostMs; }
+
+private:
+    AEffect* effect = nullptr;
+    WindowStateFn getWindowState;
+    double idleCostMs = 0.0;  // Smoothed time an effEditIdle call takes
+    int numIdleCalls = 0;
+
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EditorIdleScheduler)
+};
@@ -0,0 +1,102 @@
+#include "EngineParameters.h"
+
+#if JUCE_MSVC
+  #include <intrin.h>
+#endif
+
+void ParameterChangeQueue::push(int index, float value) noexcept {
+    if (!juce::isPositiveAndBelow(index, maxParameters)) {
+        return;
+    }
+
+    // Value first - the bit publishes it
+    values[index].store(value, std::memory_order_relaxed);
+    pending[index / 64].fetch_or((juce::uint64)1 << (index % 64), std::memory_order_release);
+}
+
+bool ParameterChangeQueue::hasPending() const noexcept {
+    for (const auto& word : pending) {
+        if (word.load(std::memory_order_relaxed) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParameterChangeQueue::clear() noexcept {
+    for (auto& word : pending) {
+        word.store(0, std::memory_order_relaxed);
+    }
+}
+
+int ParameterChangeQueue::countTrailingZeros(juce::uint64 bits) noexcept {
+    #if JUCE_MSVC
+    unsigned long index = 0;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+    #else
+    return __builtin_ctzll(bits);
+    #endif
+}
+
+EngineParameter::EngineParameter(int index, ParameterChangeQueue& queue, TextFn currentText)
+    : engineIndex(index),
+      changeQueue(queue),
+      getCurrentText(std::move(currentText))
+{
+}
+
+void EngineParameter::setEngineInfo(const juce::String& newName, const juce::String& newLabel, bool isInUse) {
+    const juce::ScopedLock sl(infoLock);
+    name = newName;
+    label = newLabel;
+    inUse = isInUse;
+}
+
+void EngineParameter::notifyHostOfEngineValue(float newValue) {
+    // Skip echoes of changes the host made itself
+    if (value.exchange(newValue, std::memory_order_relaxed) == newValue) {
+        return;
+    }
+
+    sendValueChangedMessageToListeners(newValue);
+}
+
+juce::String EngineParameter::getParameterID() const {
+    // Stable across sessions - Altiverb's parameter indices don't move
+    return "param" + juce::String(engineIndex);
+}
+
+void EngineParameter::setValue(float newValue) {
+    value.store(newValue, std::memory_order_relaxed);
+    changeQueue.push(engineIndex, newValue);
+}
+
+juce::String EngineParameter::getName(int maximumStringLength) const {
+    juce::String displayName;
+    {
+        const juce::ScopedLock sl(infoLock);
+        displayName = inUse && name.isNotEmpty() ? name : "Param " + juce::String(engineIndex + 1);
+    }
+    return displayName.substring(0, maximumStringLength);
+}
+
+juce::String EngineParameter::getLabel() const {
+    const juce::ScopedLock sl(infoLock);
+    return inUse ? label : juce::String();
+}
+
+juce::String EngineParameter::getText(float normalisedValue, int maximumStringLength) const {
+    // Altiverb can only describe the value it has - other values, and no engine, get the number
+    if (normalisedValue == getValue()) {
+        auto text = getCurrentText(engineIndex);
+        if (text.isNotEmpty()) {
+            return text.substring(0, maximumStringLength);
+        }
+    }
+    return juce::String(normalisedValue, 3).substring(0, maximumStringLength);
+}
+
+float EngineParameter::getValueForText(const juce::String& text) const {
+    return juce::jlimit(0.0f, 1.0f, text.getFloatValue());
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+// Parameter changes on their way to the audio thread.
+//
+// push() is wait-free and may be called from any thread (host automation
+// arrives on the audio thread, UI gestures on the message thread). Each
+// parameter has one slot holding its newest value and one pending bit, so
+// a burst of changes to the same parameter collapses into a single update
+// and the queue can never overflow. drain() is for the audio thread only.
+class ParameterChangeQueue {
+public:
+    static constexpr int maxParameters = 128;
+
+    ParameterChangeQueue() = default;
+
+    void push(int index, float value) noexcept;
+
+    bool hasPending() const noexcept;
+
+    // fn(index, value) for every parameter changed since the last drain
+    template <typename Fn>
+    void drain(Fn&& fn) noexcept {
+        for (int word = 0; word < numWords; ++word) {
+            auto bits = pending[word].exchange(0, std::memory_order_acquire);
+
+            while (bits != 0) {
+                const int bit = countTrailingZeros(bits);
+                bits &= bits - 1;
+
+                const int index = word * 64 + bit;
+                fn(index, values[index].load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    // Forget everything pending (state restore replaces all values)
+    void clear() noexcept;
+
+private:
+    static constexpr int numWords = maxParameters / 64;
+
+    std::atomic<float> values[maxParameters] {};
+    std::atomic<juce::uint64> pending[numWords] {};
+
+    static int countTrailingZeros(juce::uint64 bits) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterChangeQueue)
+};
+
+// One Altiverb parameter as seen by the host.
+//
+// The host's parameter list has to exist before Altiverb has loaded, so the
+// processor registers a fixed number of slots and fills in names once the
+// engine is ready. Host changes only update the cached value and go into
+// the queue - the plugin itself is touched on the audio thread. Display
+// texts are Altiverb's own, looked up through the processor.
+class EngineParameter : public juce::HostedAudioProcessorParameter {
+public:
+    // Altiverb's display text for the parameter's current value, empty without an engine
+    using TextFn = std::function<juce::String(int engineIndex)>;
+
+    EngineParameter(int engineIndex, ParameterChangeQueue& queue, TextFn currentText);
+
+    int getEngineIndex() const noexcept { return engineIndex; }
+
+    // Engine side (engine lock held): name, unit and value without queueing a change
+    void setEngineInfo(const juce::String& name, const juce::String& label, bool isInUse);
+    void setValueFromEngine(float newValue) noexcept { value.store(newValue, std::memory_order_relaxed); }
+
+    // Message thread: an edit made inside Altiverb - tell the host without queueing it back
+    void notifyHostOfEngineValue(float newValue);
+
+    // juce::HostedAudioProcessorParameter
+    juce::String getParameterID() const override;
+    float getValue() const override { return value.load(std::memory_order_relaxed); }
+    void setValue(float newValue) override;
+    float getDefaultValue() const override { return 0.0f; }
+    juce::String getName(int maximumStringLength) const override;
+    juce::String getLabel() const override;
+    juce::String getText(float normalisedValue, int maximumStringLength) const override;
+    float getValueForText(const juce::String& text) const override;
+
+private:
+    const int engineIndex;
+    ParameterChangeQueue& changeQueue;
+    std::atomic<float> value { 0.0f };
+    TextFn getCurrentText;
+
+    juce::CriticalSection infoLock;
+    juce::String name;       // Guarded by infoLock
+    juce::String label;      // Guarded by infoLock
+    bool inUse = false;      // Guarded by infoLock
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EngineParameter)
+};
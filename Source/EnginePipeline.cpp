@@ -0,0 +1,65 @@
+#include "EnginePipeline.h"
+#include "RealtimeAudit.h"
+
+EnginePipeline::EnginePipeline()
+    : juce::Thread("Altiverb Engine")
+{
+}
+
+EnginePipeline::~EnginePipeline() {
+    stop();
+}
+
+void EnginePipeline::start(BlockFn processBlock, double sampleRate, int blockSize) {
+    stop();
+
+    blockFn = std::move(processBlock);
+    busy.store(false, std::memory_order_release);
+
+    // Scheduled like an audio thread - it has one block period per block
+    const auto options = juce::Thread::RealtimeOptions()
+                             .withPriority(9)
+                             .withApproximateAudioProcessingTime(blockSize, sampleRate);
+
+    if (!startRealtimeThread(options)) {
+        startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void EnginePipeline::stop() {
+    // A block in flight is finished first
+    signalThreadShouldExit();
+    blockReady.notify();
+    stopThread(2000);
+
+    busy.store(false, std::memory_order_release);
+}
+
+void EnginePipeline::submit(float** inputs, float** outputs, int blockSize) noexcept {
+    pendingInputs = inputs;
+    pendingOutputs = outputs;
+    pendingSize = blockSize;
+    busy.store(true, std::memory_order_release);
+    blockReady.notify();
+}
+
+void EnginePipeline::waitForBlock() const noexcept {
+    // Normally done long ago - the engine had a whole block period
+    while (isBusy()) {
+        juce::Thread::yield();
+    }
+}
+
+void EnginePipeline::run() {
+    juce::ScopedNoDenormals noDenormals;
+
+    while (!threadShouldExit()) {
+        blockReady.wait(-1);
+
+        if (isBusy()) {
+            const RealtimeAudit::RealtimeSection realtimeSection;
+            blockFn(pendingInputs, pendingOutputs, pendingSize);
+            busy.store(false, std::memory_order_release);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include "WakeSignal.h"
+
+// Runs the engine one block behind the host on its own real-time thread.
+//
+// The constant-block FIFO already delays the output by a full block, but
+// processes each block inline as soon as it is full. Here the full block is
+// handed to the engine thread instead, and the host thread only comes back
+// for the result when the FIFO starts playing it out - the engine gets the
+// whole block period and the host callback is reduced to the FIFO copies.
+//
+// One block is in flight at a time. submit() and waitForBlock() are for the
+// audio thread, which alternates them.
+class EnginePipeline : private juce::Thread {
+public:
+    using BlockFn = std::function<void(float** inputs, float** outputs, int blockSize)>;
+
+    EnginePipeline();
+    ~EnginePipeline() override;
+
+    // Message thread, while the audio thread is stopped
+    void start(BlockFn processBlock, double sampleRate, int blockSize);
+    void stop();
+
+    bool isRunning() const { return isThreadRunning(); }
+
+    // Audio thread: hand over a full block, and return once the last one is done
+    void submit(float** inputs, float** outputs, int blockSize) noexcept;
+    void waitForBlock() const noexcept;
+
+    // True while a block is in flight - state restore and suspend wait for it
+    bool isBusy() const noexcept { return busy.load(std::memory_order_acquire); }
+
+private:
+    BlockFn blockFn;
+    WakeSignal blockReady;  // No lock on the audio thread
+    std::atomic<bool> busy { false };
+
+    // Written by submit() before the block is published
+    float** pendingInputs = nullptr;
+    float** pendingOutputs = nullptr;
+    int pendingSize = 0;
+
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EnginePipeline)
+};
@@ -0,0 +1,94 @@
+#include "EngineWorkerPool.h"
+#include "RealtimeAudit.h"
+
+EngineWorkerPool::~EngineWorkerPool() {
+    stop();
+}
+
+void EngineWorkerPool::start(int numWorkers, double sampleRate, int blockSize) {
+    stop();
+
+    // Scheduled like audio threads - the OS knows each has a block period to meet
+    const auto options = juce::Thread::RealtimeOptions()
+                             .withPriority(9)
+                             .withApproximateAudioProcessingTime(blockSize, sampleRate);
+
+    for (int i = 0; i < juce::jmin(numWorkers, maxWorkers); ++i) {
+        auto* worker = workers.add(new Worker(*this));
+
+        if (!worker->startRealtimeThread(options)) {
+            worker->startThread(juce::Thread::Priority::highest);
+        }
+    }
+}
+
+void EngineWorkerPool::stop() {
+    for (auto* worker : workers) {
+        worker->signalThreadShouldExit();
+        worker->wake.notify();
+    }
+
+    for (auto* worker : workers) {
+        worker->stopThread(2000);
+    }
+
+    workers.clear();
+}
+
+void EngineWorkerPool::runJobs(int numJobs, Trampoline fn, void* fnContext) {
+    jassert(numJobs > 0 && (juce::uint32)numJobs <= jobMask);
+
+    // The previous batch has finished, so no worker is reading these
+    trampoline = fn;
+    context = fnContext;
+    jobsDone.store(0, std::memory_order_relaxed);
+
+    const auto generation = (work.load(std::memory_order_relaxed) >> (2 * jobBits)) + 1;
+    work.store((generation << (2 * jobBits)) | ((juce::uint32)numJobs << jobBits), std::memory_order_release);
+
+    for (int i = 0; i < juce::jmin(workers.size(), numJobs - 1); ++i) {
+        workers.getUnchecked(i)->wake.notify();
+    }
+
+    // Work on the batch too, then join the jobs still running elsewhere
+    claimJobs();
+
+    while (jobsDone.load(std::memory_order_acquire) < numJobs) {
+        juce::Thread::yield();
+    }
+}
+
+void EngineWorkerPool::claimJobs() {
+    auto current = work.load(std::memory_order_acquire);
+
+    for (;;) {
+        const auto next = current & jobMask;
+        const auto numJobs = (current >> jobBits) & jobMask;
+
+        if (next >= numJobs) {
+            return;
+        }
+
+        if (work.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            trampoline(context, (int)next);
+            jobsDone.fetch_add(1, std::memory_order_release);
+            current = work.load(std::memory_order_acquire);
+        }
+    }
+}
+
+void EngineWorkerPool::Worker::run() {
+    juce::ScopedNoDenormals noDenormals;
+
+    while (!threadShouldExit()) {
+        wake.wait(-1);
+
+        if (threadShouldExit()) {
+            break;
+        }
+
+        // The jobs are real-time, the wait for them isn't
+        const RealtimeAudit::RealtimeSection realtimeSection;
+        pool.claimJobs();
+    }
+}
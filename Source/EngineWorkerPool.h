@@ -0,0 +1,66 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include "SpeakerLayout.h"
+#include "WakeSignal.h"
+
+// Real-time worker threads that run an instance's split engines side by side.
+//
+// The audio thread publishes a batch of jobs, wakes the workers and then works
+// on the batch itself. Every thread claims the next unstarted job from one
+// shared counter, so a worker that wakes late just finds its share already
+// taken: the audio thread never waits for a job nobody has started, only for
+// the ones still running. Workers are started with real-time priority, sized
+// to the host's block period.
+class EngineWorkerPool {
+public:
+    // The audio thread runs one group itself
+    static constexpr int maxWorkers = SpeakerLayout::maxGroups - 1;
+
+    EngineWorkerPool() = default;
+    ~EngineWorkerPool();
+
+    // Message thread, while the audio thread is stopped
+    void start(int numWorkers, double sampleRate, int blockSize);
+    void stop();
+
+    int getNumWorkers() const noexcept { return workers.size(); }
+
+    // Audio thread: fn(job) for every job in 0..numJobs-1, returns once all have finished
+    template <typename JobFn>
+    void run(int numJobs, JobFn& fn) {
+        runJobs(numJobs, [](void* context, int job) { (*static_cast<JobFn*>(context))(job); }, &fn);
+    }
+
+private:
+    using Trampoline = void (*)(void* context, int job);
+
+    class Worker : public juce::Thread {
+    public:
+        explicit Worker(EngineWorkerPool& owner) : juce::Thread("Altiverb Engine Worker"), pool(owner) {}
+        void run() override;
+
+        WakeSignal wake;  // Notified by the audio thread - no lock
+
+    private:
+        EngineWorkerPool& pool;
+    };
+
+    juce::OwnedArray<Worker> workers;
+
+    // The current batch. work packs generation, batch size and next job, so a
+    // stale claim from the previous batch can never succeed.
+    static constexpr juce::uint32 jobBits = 8;
+    static constexpr juce::uint32 jobMask = (1u << jobBits) - 1;
+    std::atomic<juce::uint32> work { 0 };
+    std::atomic<int> jobsDone { 0 };
+    Trampoline trampoline = nullptr;  // Written before work is published
+    void* context = nullptr;
+
+    void runJobs(int numJobs, Trampoline fn, void* fnContext);
+
+    // Run unclaimed jobs of the current batch until there are none left
+    void claimJobs();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EngineWorkerPool)
+};
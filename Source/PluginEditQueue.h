@@ -0,0 +1,64 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include "BridgeProtocol.h"
+
+// Edits made in Altiverb's own editor, on their way to the host.
+//
+// The plugin reports them through audioMasterAutomate/BeginEdit/EndEdit/
+// UpdateDisplay, on whatever thread it likes. push() never waits: the ring
+// is single-producer, so a second thread calling back at the same moment
+// doesn't queue its event but flags a resync instead, as does a full ring.
+// The message thread drains the queue once per UI frame.
+struct PluginEdit {
+    enum class Type : juce::uint8 {
+        valueChanged,     // audioMasterAutomate
+        gestureBegin,     // audioMasterBeginEdit
+        gestureEnd,       // audioMasterEndEdit
+        displayChanged    // audioMasterUpdateDisplay - anything may have changed
+    };
+
+    Type type = Type::valueChanged;
+    int index = 0;
+    float value = 0.0f;
+};
+
+class PluginEditQueue {
+public:
+    static constexpr int capacity = 512;
+
+    PluginEditQueue() { ring.reset(); }
+
+    // Plugin callback thread
+    void push(PluginEdit::Type type, int index, float value) noexcept {
+        if (producerBusy.test_and_set(std::memory_order_acquire)) {
+            resyncNeeded.store(true, std::memory_order_release);
+            return;
+        }
+
+        if (!ring.push({ type, index, value })) {
+            resyncNeeded.store(true, std::memory_order_release);
+        }
+
+        producerBusy.clear(std::memory_order_release);
+    }
+
+    // Message thread: fn(const PluginEdit&) for each queued edit, oldest first
+    template <typename Fn>
+    void drain(Fn&& fn) {
+        PluginEdit edit;
+        while (ring.pop(edit)) {
+            fn(edit);
+        }
+    }
+
+    // True once after events were dropped - the consumer rereads every value
+    bool takeResyncRequest() noexcept { return resyncNeeded.exchange(false, std::memory_order_acq_rel); }
+
+private:
+    BridgeProtocol::SpscRing<PluginEdit, capacity> ring;
+    std::atomic_flag producerBusy = ATOMIC_FLAG_INIT;
+    std::atomic<bool> resyncNeeded { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginEditQueue)
+};
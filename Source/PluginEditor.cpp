@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "RoutingPanel.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -23,7 +24,7 @@ AltiverbSurroundEditor::AltiverbSurroundEditor(AltiverbSurroundProcessor& p)
     : AudioProcessorEditor(&p), audioProcessor(p)
 {
     // Create simple "Open Altiverb" button interface
-    setSize(400, 160);
+    setSize(400, 300);
     
     // Add "Open Altiverb Editor" button
     openButton.setButtonText("Open Altiverb Editor");
@@ -39,6 +40,37 @@ AltiverbSurroundEditor::AltiverbSurroundEditor(AltiverbSurroundProcessor& p)
     };
     addAndMakeVisible(browseButton);
     
+    // Add constant-block mode toggle (trades one block of latency for steady engine blocks)
+    constantBlockToggle.setButtonText("Constant block size (+1 block latency)");
+    constantBlockToggle.setToggleState(audioProcessor.isConstantBlockModeEnabled(), juce::dontSendNotification);
+    constantBlockToggle.onClick = [this] {
+        audioProcessor.setConstantBlockModeEnabled(constantBlockToggle.getToggleState());
+    };
+    addAndMakeVisible(constantBlockToggle);
+    
+    // Add split engines toggle (one Altiverb per channel group, run on several cores)
+    splitEnginesToggle.setButtonText("Split engines across cores (groups reverberate separately)");
+    splitEnginesToggle.setToggleState(audioProcessor.isEngineSplitEnabled(), juce::dontSendNotification);
+    splitEnginesToggle.onClick = [this] {
+        audioProcessor.setEngineSplitEnabled(splitEnginesToggle.getToggleState());
+    };
+    addAndMakeVisible(splitEnginesToggle);
+    
+    // Add pipelined mode toggle (Altiverb on its own thread, one block behind the host)
+    pipelinedToggle.setButtonText("Run Altiverb on its own thread (+1 block latency)");
+    pipelinedToggle.setToggleState(audioProcessor.isPipelinedModeEnabled(), juce::dontSendNotification);
+    pipelinedToggle.onClick = [this] {
+        audioProcessor.setPipelinedModeEnabled(pipelinedToggle.getToggleState());
+    };
+    addAndMakeVisible(pipelinedToggle);
+    
+    // Add channel routing (order, trim, polarity) in a call-out
+    routingButton.setButtonText("Channel Routing...");
+    routingButton.onClick = [this] {
+        showRoutingPanel();
+    };
+    addAndMakeVisible(routingButton);
+    
     // Add status label
     statusLabel.setText("Altiverb 7 XL Surround Wrapper", juce::dontSendNotification);
     statusLabel.setJustificationType(juce::Justification::centred);
@@ -51,9 +83,18 @@ AltiverbSurroundEditor::AltiverbSurroundEditor(AltiverbSurroundProcessor& p)
     pathLabel.setJustificationType(juce::Justification::centred);
     pathLabel.setFont(juce::Font(11.0f));
     addAndMakeVisible(pathLabel);
+    
+    // Add DSP load readout (refreshed by the timer)
+    loadLabel.setJustificationType(juce::Justification::centred);
+    loadLabel.setFont(juce::Font(11.0f));
+    addAndMakeVisible(loadLabel);
+    
+    timerCallback();
+    startTimerHz(4);
 }
 
 AltiverbSurroundEditor::~AltiverbSurroundEditor() {
+    stopTimer();
     closeAltiverbWindow();
 }
 
@@ -73,21 +114,66 @@ void AltiverbSurroundEditor::resized() {
     // Layout simple button interface
     statusLabel.setBounds(bounds.removeFromTop(25).reduced(10, 5));
     pathLabel.setBounds(bounds.removeFromTop(20).reduced(10, 2));
+    loadLabel.setBounds(bounds.removeFromBottom(20).reduced(10, 2));
     
     auto buttonArea = bounds.reduced(20, 10);
     openButton.setBounds(buttonArea.removeFromTop(40));
     buttonArea.removeFromTop(10); // spacing
     browseButton.setBounds(buttonArea.removeFromTop(40));
+    buttonArea.removeFromTop(5); // spacing
+    constantBlockToggle.setBounds(buttonArea.removeFromTop(24));
+    buttonArea.removeFromTop(5); // spacing
+    splitEnginesToggle.setBounds(buttonArea.removeFromTop(24));
+    buttonArea.removeFromTop(5); // spacing
+    pipelinedToggle.setBounds(buttonArea.removeFromTop(24));
+    buttonArea.removeFromTop(5); // spacing
+    routingButton.setBounds(buttonArea.removeFromTop(24));
 }
 
 void AltiverbSurroundEditor::timerCallback() {
-    // Simplified - no idle updates needed for button interface
+    // Reflect background loading
+    auto engineState = audioProcessor.getEngineState();
+    openButton.setEnabled(engineState == AsyncEngineLoader::State::ready);
+    
+    if (engineState == AsyncEngineLoader::State::loading) {
+        statusLabel.setText("Loading Altiverb...", juce::dontSendNotification);
+    } else if (engineState == AsyncEngineLoader::State::ready) {
+        statusLabel.setText("Altiverb 7 XL Surround Wrapper", juce::dontSendNotification);
+    } else {
+        statusLabel.setText("Altiverb not loaded - check the VST2 path", juce::dontSendNotification);
+    }
+    
+    // Edits in Altiverb's own window don't always arrive as automation - while it
+    // has focus, count the instance as changed so its snapshot gets refreshed
+    if (altiverbWindow && altiverbWindow->isActiveWindow()) {
+        if (auto* loader = audioProcessor.getVST2Loader()) {
+            loader->markStateChanged();
+        }
+    }
+    
+    // Poll this instance's DSP load
+    auto load = audioProcessor.getDspLoadSnapshot();
+    
+    if (load.numBlocks == 0) {
+        loadLabel.setText("DSP load: idle", juce::dontSendNotification);
+        return;
+    }
+    
+    loadLabel.setText("DSP " + juce::String(load.averageLoad * 100.0, 1) + "% avg, "
+                      + juce::String(load.peakLoad * 100.0, 1) + "% peak | p99 "
+                      + juce::String(load.p99CallMicroseconds, 0) + " us | "
+                      + juce::String(load.numOverruns) + " overruns"
+                      + (audioProcessor.getNumActiveEngines() > 1 ? " | " + juce::String(audioProcessor.getNumActiveEngines()) + " engines" : "")
+                      + (audioProcessor.isEngineAsleep() ? " | asleep" : ""),
+                      juce::dontSendNotification);
+    loadLabel.setColour(juce::Label::textColourId,
+                        load.numOverruns > 0 ? juce::Colours::orange : juce::Colours::lightgrey);
 }
 
 void AltiverbSurroundEditor::openAltiverbWindow() {
     // Check if Altiverb is loaded and has editor
     auto* loader = audioProcessor.getVST2Loader();
-    if (!loader || !loader->hasEditor()) {
+    if (!audioProcessor.isEngineReady() || !loader || !loader->hasEditor()) {
         return;
     }
     
@@ -111,19 +197,50 @@ void AltiverbSurroundEditor::openAltiverbWindow() {
         
         // Make window visible BEFORE opening VST2 editor
         altiverbWindow->setVisible(true);
-        
-        // Small delay to ensure window is fully created
-        juce::Thread::sleep(50);
-        
-        // Create VST2 editor content for popup window
-        #if JUCE_WINDOWS
-        auto* hwnd = (HWND)altiverbWindow->getWindowHandle();
-        if (hwnd) {
-            loader->openEditor(hwnd);
-        } else {
+    }
+    catch (...) {
+        closeAltiverbWindow();
+        return;
+    }
+    
+    // The VST2 editor goes in once the native window is up
+    attachWhenWindowReady(++windowGeneration, windowReadyAttempts);
+}
+
+void AltiverbSurroundEditor::attachWhenWindowReady(int generation, int attemptsLeft) {
+    if (!altiverbWindow || generation != windowGeneration) {
+        return;  // Closed or reopened meanwhile
+    }
+    
+    if (!isAltiverbWindowReady()) {
+        if (attemptsLeft <= 0) {
             closeAltiverbWindow();
             return;
         }
+        
+        // Check back from the message loop instead of blocking it
+        juce::Component::SafePointer<AltiverbSurroundEditor> safeThis(this);
+        juce::Timer::callAfterDelay(windowReadyPollMs, [safeThis, generation, attemptsLeft] {
+            if (safeThis) {
+                safeThis->attachWhenWindowReady(generation, attemptsLeft - 1);
+            }
+        });
+        return;
+    }
+    
+    auto* loader = audioProcessor.getVST2Loader();
+    if (!audioProcessor.isEngineReady() || !loader) {
+        closeAltiverbWindow();
+        return;
+    }
+    
+    try {
+        // Create VST2 editor content for popup window
+        #if JUCE_WINDOWS
+        loader->openEditor((HWND)altiverbWindow->getWindowHandle());
+        
+        // Some editors report a failed open and show up anyway - idle it regardless
+        idleScheduler.start(loader->getEffect(), [this] { return getAltiverbWindowState(); });
         #endif
     }
     catch (...) {
@@ -131,13 +248,44 @@ void AltiverbSurroundEditor::openAltiverbWindow() {
     }
 }
 
+bool AltiverbSurroundEditor::isAltiverbWindowReady() const {
+    if (!altiverbWindow->isOnDesktop() || !altiverbWindow->isShowing()
+        || altiverbWindow->getWindowHandle() == nullptr) {
+        return false;
+    }
+    
+    #if JUCE_WINDOWS
+    return IsWindowVisible((HWND)altiverbWindow->getWindowHandle()) != FALSE;
+    #else
+    return true;
+    #endif
+}
+
+EditorIdleScheduler::WindowState AltiverbSurroundEditor::getAltiverbWindowState() const {
+    if (!altiverbWindow) {
+        return EditorIdleScheduler::WindowState::closed;
+    }
+    if (altiverbWindow->isMinimised()) {
+        return EditorIdleScheduler::WindowState::minimised;
+    }
+    return altiverbWindow->isShowing() ? EditorIdleScheduler::WindowState::visible
+                                       : EditorIdleScheduler::WindowState::hidden;
+}
+
 void AltiverbSurroundEditor::closeAltiverbWindow() {
+    idleScheduler.stop();
+    
     if (altiverbWindow) {
         // Let the DAW handle VST2 editor lifecycle
         altiverbWindow.reset();
     }
 }
 
+void AltiverbSurroundEditor::showRoutingPanel() {
+    juce::CallOutBox::launchAsynchronously(std::make_unique<RoutingPanel>(audioProcessor),
+                                           routingButton.getScreenBounds(), nullptr);
+}
+
 void AltiverbSurroundEditor::browseForVST2Path() {
     // Create file chooser for VST2 DLL files
     auto chooser = std::make_unique<juce::FileChooser>("Select Altiverb VST2 Plugin",
@@ -1,6 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "EditorIdleScheduler.h"
 
 // Forward declaration
 class AltiverbSurroundEditor;
@@ -33,14 +34,30 @@ private:
     // Simple button GUI components
     juce::TextButton openButton;
     juce::TextButton browseButton;
+    juce::ToggleButton constantBlockToggle;
+    juce::ToggleButton splitEnginesToggle;
+    juce::ToggleButton pipelinedToggle;
+    juce::TextButton routingButton;
     juce::Label statusLabel;
     juce::Label pathLabel;
+    juce::Label loadLabel;
     
     // Popup window for Altiverb
     std::unique_ptr<AltiverbDocumentWindow> altiverbWindow;
+    EditorIdleScheduler idleScheduler;
+    
+    // The native window is polled until it is up, rather than waited for -
+    // a reopened window starts a new generation, so stale polls drop out
+    static constexpr int windowReadyPollMs = 10;
+    static constexpr int windowReadyAttempts = 200;
+    int windowGeneration = 0;
     
     void openAltiverbWindow();
+    void attachWhenWindowReady(int generation, int attemptsLeft);
+    bool isAltiverbWindowReady() const;
+    EditorIdleScheduler::WindowState getAltiverbWindowState() const;
     void browseForVST2Path();
+    void showRoutingPanel();
     
 public:
     void closeAltiverbWindow();
@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "RealtimeAudit.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -13,24 +14,395 @@ AltiverbSurroundProcessor::AltiverbSurroundProcessor()
                        .withInput  ("Input",  juce::AudioChannelSet::create5point1(), true)
                        .withOutput ("Output", juce::AudioChannelSet::create5point1(), true))
 {
-    // Add dummy parameter to ensure state management is called
-    addParameter(dummyParam = new juce::AudioParameterFloat("dummy", "Dummy", 0.0f, 1.0f, 0.0f));
+    // Host parameters for Altiverb's own - names are filled in once the engine has loaded
+    for (int i = 0; i < ParameterChangeQueue::maxParameters; ++i) {
+        auto* parameter = new EngineParameter(i, parameterQueue, [this](int index) { return getEngineParameterText(index); });
+        engineParameters.add(parameter);
+        addParameter(parameter);
+    }
     
-    // Create VST2Loader and try to load plugin immediately
+    // Create VST2Loader and its background loader
     vst2Loader = std::make_unique<VST2Loader>();
+    engineLoader = std::make_unique<AsyncEngineLoader>(*vst2Loader, engineLock);
+    
+    for (int group = 1; group < SpeakerLayout::maxGroups; ++group) {
+        groupEngines[group - 1] = std::make_unique<VST2Loader>();
+        groupLoaders[group - 1] = std::make_unique<AsyncEngineLoader>(*groupEngines[group - 1], engineLock);
+    }
+    stateRestorer = std::make_unique<StateRestorer>([this] { runPendingRestore(); });
+    snapshotCache = std::make_unique<StateSnapshotCache>([this] { return vst2Loader->getStateChangeCount(); },
+                                                         [this] (juce::MemoryBlock& dest) { return takeSnapshot(dest); });
+    
+    // Forward edits made in Altiverb's own editor to the host
+    startTimerHz(editForwardingHz);
     
-    // Try to load Altiverb early so it's available for state management
+    // Optionally host Altiverb in AltiverbBridgeHost so a plugin crash can't take the DAW down
+    vst2Loader->setUseBridge(loadFlagFromRegistry("UseBridge"));
+    
+    // Start loading Altiverb early - audio passes through until it is ready
     juce::String vst2Path = getVST2Path();
     if (juce::File(vst2Path).existsAsFile()) {
-        if (vst2Loader->loadPlugin(vst2Path.toUTF8())) {
-            pluginLoaded = true;
-            
-        }
+        startEngineLoad(vst2Path);
     }
 }
 
 AltiverbSurroundProcessor::~AltiverbSurroundProcessor() {
-    // Clean shutdown
+    stopTimer();
+    
+    // Let a snapshot, restore or load in progress finish before the engine goes away
+    snapshotCache.reset();
+    stateRestorer.reset();
+    engineLoader.reset();
+    
+    for (auto& loader : groupLoaders) {
+        loader.reset();
+    }
+}
+
+void AltiverbSurroundProcessor::startEngineLoad(const juce::String& path) {
+    engineLoader->startLoading(path, [this] { onEngineLoaded(); });
+}
+
+bool AltiverbSurroundProcessor::loadEngineAndWait(const juce::String& path) {
+    // A load of the saved path, started by the constructor, finishes first
+    engineLoader->waitUntilSettled();
+    startEngineLoad(path);
+    engineLoader->waitUntilSettled();
+    return engineLoader->isReady();
+}
+
+void AltiverbSurroundProcessor::onEngineLoaded() {
+    // Loader thread, engine lock held - runs before the engine is published as ready
+    if (prepared) {
+        configureEngine();
+    }
+    
+    // Apply state the host handed us while we were loading
+    if (pendingState.getSize() > 0) {
+        applyPendingState();
+    } else {
+        syncParametersFromEngine();
+    }
+}
+
+void AltiverbSurroundProcessor::syncParametersFromEngine() {
+    // Engine lock held, audio not in the engine - host parameters take the engine's values
+    parameterQueue.clear();
+    
+    const int numEngineParams = vst2Loader->getNumParameters();
+    for (auto* parameter : engineParameters) {
+        const int index = parameter->getEngineIndex();
+        const bool inUse = index < numEngineParams;
+        
+        parameter->setEngineInfo(inUse ? vst2Loader->getParameterName(index) : juce::String(),
+                                 inUse ? vst2Loader->getParameterLabel(index) : juce::String(), inUse);
+        parameter->setValueFromEngine(inUse ? vst2Loader->getParameter(index) : 0.0f);
+    }
+    
+    updateHostDisplay(ChangeDetails().withParameterInfoChanged(true));
+}
+
+void AltiverbSurroundProcessor::timerCallback() {
+    // The group engines have finished loading - re-prepare so the next blocks split
+    if (groupEnginesLoaded.exchange(false) && prepared) {
+        suspendProcessing(true);
+        releaseResources();
+        prepareToPlay(currentSampleRate, currentBlockSize);
+        suspendProcessing(false);
+    }
+    
+    forwardPluginEdits();
+    syncGroupEnginesIfDirty();
+    updateBypassedEngine();
+}
+
+void AltiverbSurroundProcessor::forwardPluginEdits() {
+    // Message thread - a restore in progress resyncs the parameters itself
+    auto& editQueue = vst2Loader->getEditQueue();
+    
+    if (!engineLoader->isReady() || stateRestorer->isBusy()) {
+        editQueue.drain([](const PluginEdit&) {});
+        editQueue.takeResyncRequest();
+        return;
+    }
+    
+    auto flushValue = [this](int index) {
+        if (valueEdited[index]) {
+            engineParameters[index]->notifyHostOfEngineValue(editedValues[index]);
+            valueEdited[index] = false;
+        }
+    };
+    
+    bool resync = false;
+    
+    // Keep only the newest value per parameter, but keep gestures in order around it
+    editQueue.drain([&](const PluginEdit& edit) {
+        if (edit.type == PluginEdit::Type::displayChanged) {
+            resync = true;
+            return;
+        }
+        
+        if (!juce::isPositiveAndBelow(edit.index, engineParameters.size())) {
+            return;
+        }
+        
+        switch (edit.type) {
+            case PluginEdit::Type::valueChanged:
+                editedValues[edit.index] = edit.value;
+                valueEdited[edit.index] = true;
+                
+                if (numEngineGroups > 1) {
+                    mirrorQueue.push(edit.index, edit.value);
+                }
+                break;
+                
+            case PluginEdit::Type::gestureBegin:
+                if (!gestureOpen[edit.index]) {
+                    engineParameters[edit.index]->beginChangeGesture();
+                    gestureOpen[edit.index] = true;
+                }
+                break;
+                
+            case PluginEdit::Type::gestureEnd:
+                flushValue(edit.index);
+                if (gestureOpen[edit.index]) {
+                    engineParameters[edit.index]->endChangeGesture();
+                    gestureOpen[edit.index] = false;
+                }
+                break;
+                
+            case PluginEdit::Type::displayChanged:
+                break;
+        }
+    });
+    
+    for (int i = 0; i < engineParameters.size(); ++i) {
+        flushValue(i);
+    }
+    
+    if (editQueue.takeResyncRequest() || resync) {
+        resyncParametersFromEngine();
+        requestGroupSync();
+    }
+}
+
+void AltiverbSurroundProcessor::resyncParametersFromEngine() {
+    // Message thread - some edits weren't reported one by one, compare every value.
+    // The group engines get the values too, which is much cheaper than a chunk.
+    const int numEngineParams = juce::jmin(vst2Loader->getNumParameters(), engineParameters.size());
+    for (int i = 0; i < numEngineParams; ++i) {
+        const float value = vst2Loader->getParameter(i);
+        engineParameters[i]->notifyHostOfEngineValue(value);
+        
+        if (numEngineGroups > 1) {
+            mirrorQueue.push(i, value);
+        }
+    }
+    
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+}
+
+void AltiverbSurroundProcessor::applyParameterChanges() {
+    // Audio thread, between two engine calls
+    parameterQueue.drain([this](int index, float value) {
+        vst2Loader->setParameter(index, value);
+        
+        for (int group = 1; group < numEngineGroups; ++group) {
+            groupEngines[group - 1]->setParameter(index, value);
+        }
+    });
+    
+    // Edits made in Altiverb's editor are already in the first engine
+    mirrorQueue.drain([this](int index, float value) {
+        for (int group = 1; group < numEngineGroups; ++group) {
+            groupEngines[group - 1]->setParameter(index, value);
+        }
+    });
+}
+
+void AltiverbSurroundProcessor::configureEngine() {
+    // The group engines first - they decide the layout the first engine runs
+    configureGroupEngines();
+    
+    // Bouncing or freezing - Altiverb asks for the process level
+    const VstInt32 processLevel = offlineRendering ? kVstProcessLevelOffline : kVstProcessLevelUnknown;
+    vst2Loader->setProcessLevel(processLevel);
+    for (int group = 1; group < numEngineGroups; ++group) {
+        groupEngines[group - 1]->setProcessLevel(processLevel);
+    }
+    
+    vst2Loader->setSampleRate(currentSampleRate);
+    vst2Loader->setBlockSize(maxChunkSize);
+    
+    // Altiverb's own 64-bit path for a double-precision host, unless routing, the
+    // constant-block FIFO (pipelined or not) or split engines need floats anyway. Negotiated while suspended.
+    bool useDoubleEngine = false;
+    if (vst2Loader->canProcessDouble()) {
+        const bool wantDouble = isUsingDoublePrecision() && processingPath != ProcessingPath::mapped
+                                && !scheduler.isConstantBlockMode() && numEngineGroups == 1;
+        useDoubleEngine = vst2Loader->setProcessPrecision(wantDouble) && wantDouble;
+    }
+    doublePrecisionEngine.store(useDoubleEngine);
+    
+    vst2Loader->resume();
+    
+    // FORCE THE HOST'S LAYOUT AFTER RESUME - pooled engines come negotiated to 5.1
+    vst2Loader->setSpeakerLayout(numEngineGroups > 1 ? speakerLayout->getGroupLayout(0) : *speakerLayout);
+    
+    auto* effect = vst2Loader->getEffect();
+    if (effect) {
+        // Reverb tail, if the plugin knows it - the silence gate measures it otherwise
+        silenceGate.setPluginTailSamples((int)effect->dispatcher(effect, effGetTailSize, 0, 0, nullptr, 0.0f));
+        
+        // Altiverb's own latency, reported to the host and matched by the bypass delay
+        if (pluginLatencySamples.exchange(effect->initialDelay) != effect->initialDelay) {
+            updateLatency();
+        }
+    }
+}
+
+void AltiverbSurroundProcessor::configureGroupEngines() {
+    // Engine lock held, audio thread out of the engines. Only a complete set of
+    // group engines splits - otherwise the first engine runs every channel while
+    // the missing ones load in the background. Cold loads (empty warm pool, bridged
+    // engines) never hold up the host's thread.
+    const int wantedGroups = engineSplitEnabled ? speakerLayout->numGroups : 1;
+    wantedEngineGroups = wantedGroups;
+    bool complete = true;
+    
+    for (int group = 1; group < SpeakerLayout::maxGroups; ++group) {
+        auto& engine = *groupEngines[group - 1];
+        auto& loader = *groupLoaders[group - 1];
+        
+        if (loader.isLoading()) {
+            complete = complete && group >= wantedGroups;  // Finishes on its own - onGroupEngineLoaded decides
+            continue;
+        }
+        
+        const bool current = loader.isReady() && engine.getPluginPath() == vst2Loader->getPluginPath()
+                             && engine.isUsingBridge() == vst2Loader->isUsingBridge();
+        
+        if (group >= wantedGroups || !current) {
+            if (loader.getState() != AsyncEngineLoader::State::unloaded) {
+                loader.unload();
+            }
+        }
+        
+        if (group >= wantedGroups) {
+            continue;
+        }
+        
+        // Cloned from the first engine, so that one has to be there first
+        if (!current && !engineLoader->isReady()) {
+            complete = false;
+        } else if (!current) {
+            engine.setUseBridge(vst2Loader->isUsingBridge());
+            loader.startLoading(vst2Loader->getPluginPath(), [this, group] { onGroupEngineLoaded(group); });
+            complete = false;
+        }
+    }
+    
+    numEngineGroups = complete ? wantedGroups : 1;
+    mirrorQueue.clear();
+    
+    if (numEngineGroups == 1) {
+        return;
+    }
+    
+    // Same state as the first engine, resumed at our rate and block size
+    captureEngineState(mirroredState);
+    
+    for (int group = 1; group < numEngineGroups; ++group) {
+        restoreEngineState(*groupEngines[group - 1], mirroredState);
+        groupEngines[group - 1]->setSpeakerLayout(speakerLayout->getGroupLayout(group));
+    }
+}
+
+void AltiverbSurroundProcessor::onGroupEngineLoaded(int loadedGroup) {
+    // Group loader thread, engine lock held. Once every wanted load has settled the
+    // timer re-prepares: that splits the engine, or restarts a load that went stale.
+    if (wantedEngineGroups == 1 || numEngineGroups > 1) {
+        return;
+    }
+    
+    for (int group = 1; group < wantedEngineGroups; ++group) {
+        if (group != loadedGroup && groupLoaders[group - 1]->isLoading()) {
+            return;
+        }
+    }
+    
+    groupEnginesLoaded.store(true);
+}
+
+void AltiverbSurroundProcessor::mirrorStateToGroupEngines() {
+    // Engine lock held, audio out of the engines
+    if (numEngineGroups == 1) {
+        return;
+    }
+    
+    mirrorQueue.clear();
+    captureEngineState(mirroredState);
+    
+    for (int group = 1; group < numEngineGroups; ++group) {
+        restoreEngineState(*groupEngines[group - 1], mirroredState);
+    }
+}
+
+void AltiverbSurroundProcessor::requestGroupSync() {
+    // Any thread - program or IR changed in the first engine. Only marks the group
+    // engines dirty; the timer syncs them, so a burst of changes costs one chunk.
+    if (numEngineGroups > 1) {
+        groupEnginesDirty.store(true);
+    }
+}
+
+void AltiverbSurroundProcessor::syncGroupEnginesIfDirty() {
+    // Message thread. At most one state capture per interval, and none while a
+    // restore is running - it brings the group engines up to date itself.
+    const juce::uint32 now = juce::Time::getMillisecondCounter();
+    if (now - lastGroupSyncTime < (juce::uint32)groupSyncIntervalMs || stateRestorer->isBusy()
+        || !groupEnginesDirty.exchange(false)) {
+        return;
+    }
+    
+    lastGroupSyncTime = now;
+    
+    {
+        const juce::ScopedLock sl(engineLock);
+        
+        if (numEngineGroups == 1 || !engineLoader->isReady()) {
+            return;
+        }
+        
+        // Keeping audio out of the engines is only worth it if the state really differs
+        // from the mirrored one. Parameter values reach them through the mirror queue.
+        WrapperState state;
+        captureEngineState(state);
+        
+        if (state.chunk == mirroredState.chunk && state.currentProgram == mirroredState.currentProgram) {
+            return;
+        }
+    }
+    
+    groupSyncRequested.store(true);
+    stateRestorer->schedule();
+}
+
+void AltiverbSurroundProcessor::setEngineSplitEnabled(bool shouldBeEnabled) {
+    if (engineSplitEnabled == shouldBeEnabled) {
+        return;
+    }
+    
+    engineSplitEnabled = shouldBeEnabled;
+    vst2Loader->markStateChanged();  // Saved with the project
+    
+    // Re-prepare so the group engines and worker threads follow
+    if (prepared) {
+        suspendProcessing(true);
+        releaseResources();
+        prepareToPlay(currentSampleRate, currentBlockSize);
+        suspendProcessing(false);
+    }
 }
 
 const juce::String AltiverbSurroundProcessor::getName() const {
@@ -40,29 +412,35 @@ const juce::String AltiverbSurroundProcessor::getName() const {
 bool AltiverbSurroundProcessor::acceptsMidi() const { return false; }
 bool AltiverbSurroundProcessor::producesMidi() const { return false; }
 bool AltiverbSurroundProcessor::isMidiEffect() const { return false; }
-double AltiverbSurroundProcessor::getTailLengthSeconds() const { return 0.0; }
+double AltiverbSurroundProcessor::getTailLengthSeconds() const { return silenceGate.getTailSeconds(); }
 
 int AltiverbSurroundProcessor::getNumPrograms() {
-    if (!pluginLoaded) return 1;
+    if (!isEngineReady()) return 1;
     return vst2Loader->getNumPrograms();
 }
 
 int AltiverbSurroundProcessor::getCurrentProgram() {
-    if (!pluginLoaded) return 0;
+    if (!isEngineReady()) return 0;
     return vst2Loader->getCurrentProgram();
 }
 
 void AltiverbSurroundProcessor::setCurrentProgram(int index) {
-    if (pluginLoaded) {
+    if (isEngineReady()) {
         vst2Loader->setCurrentProgram(index);
+        requestGroupSync();
     }
 }
 
 const juce::String AltiverbSurroundProcessor::getProgramName(int index) {
-    if (!pluginLoaded) return {};
+    if (!isEngineReady()) return {};
     return vst2Loader->getProgramName(index);
 }
 
+juce::String AltiverbSurroundProcessor::getEngineParameterText(int index) {
+    if (!isEngineReady() || index >= vst2Loader->getNumParameters()) return {};
+    return vst2Loader->getParameterText(index);
+}
+
 void AltiverbSurroundProcessor::changeProgramName(int index, const juce::String& newName) {
     // Not implemented for VST2 wrapper
 }
@@ -70,122 +448,761 @@ void AltiverbSurroundProcessor::changeProgramName(int index, const juce::String&
 void AltiverbSurroundProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
+    offlineRendering = isNonRealtime();
     
-    // Prepare internal buffers for 6 channels (5.1)
-    internalInputBuffer.setSize(6, samplesPerBlock);
-    internalOutputBuffer.setSize(6, samplesPerBlock);
+    // Surround format from the host's buses, then the processing path for it -
+    // identity routing lets us skip the copies
+    speakerLayout = chooseSpeakerLayout();
+    copyChannels = ChannelKernels::getCopyKernel(speakerLayout->numChannels);
+    jassert(copyChannels != nullptr);
+    gainCopy = ChannelKernels::getGainCopyKernel();
+    {
+        const juce::ScopedLock sl(engineLock);
+        routingMatrix.build(channelRouting, *speakerLayout);
+        routingPassThrough = channelRouting.isPassThrough();
+    }
+    processingPath = chooseProcessingPath();
     
-    // Setup channel pointers
-    inputChannelPtrs.resize(6);
-    outputChannelPtrs.resize(6);
+    // Preallocate all scratch memory the chosen path needs
+    prepareScratchArena(samplesPerBlock);
+    updateLatency();
     
-    // Try to load Altiverb if not loaded yet
-    if (!pluginLoaded) {
+    // Pipelined: full FIFO blocks go to the engine thread
+    if (scheduler.isPipelined()) {
+        enginePipeline.start([this](float** inputs, float** outputs, int blockSize) {
+            processFifoBlock(inputs, outputs, blockSize);
+        }, sampleRate, samplesPerBlock);
+    }
+    loadMetrics.prepare(sampleRate);
+    silenceGate.prepare(sampleRate);
+    
+    if (RealtimeAudit::enabled) {
+        RealtimeAudit::beginSession();
+    }
+    
+    // Start engaged - a bypassed host sends the first processBlockBypassed straight away
+    bypassFadeLength = juce::jmax(1, juce::roundToInt(sampleRate * bypassFadeSeconds));
+    bypassFadePosition = 0;
+    bypassState.store(BypassState::engaged);
+    engineSuspendedForBypass = false;
+    
+    // Host parameter changes reach Altiverb at most this often - a fader drag
+    // becomes a handful of updates instead of one per host block
+    parameterApplyInterval = juce::jmax(1, juce::roundToInt(sampleRate * parameterApplyIntervalSeconds));
+    samplesSinceParameterApply = parameterApplyInterval;
+    
+    // One worker per group engine - the audio thread runs the first group itself
+    if (engineSplitEnabled) {
+        workerPool.start(speakerLayout->numGroups - 1, sampleRate, samplesPerBlock);
+    } else {
+        workerPool.stop();
+    }
+    
+    const juce::ScopedLock sl(engineLock);
+    prepared = true;
+    
+    if (engineLoader->isReady()) {
+        configureEngine();
+    } else if (!engineLoader->isLoading()) {
+        // Not loaded yet (or the last attempt failed) - try again in the background
         juce::String vst2Path = getVST2Path();
-        if (vst2Loader->loadPlugin(vst2Path.toUTF8())) {
-            pluginLoaded = true;
+        if (juce::File(vst2Path).existsAsFile()) {
+            startEngineLoad(vst2Path);
         }
     }
+    // A load in progress configures the engine itself once it opens
+}
+
+void AltiverbSurroundProcessor::releaseResources() {
+    // Lets a block in flight finish first
+    enginePipeline.stop();
+    
+    // Audit builds report what the audio threads did since prepareToPlay
+    if (RealtimeAudit::enabled) {
+        juce::Logger::writeToLog(RealtimeAudit::getSummary().toString());
+    }
+    
+    const juce::ScopedLock sl(engineLock);
+    prepared = false;
     
-    if (pluginLoaded) {
-        vst2Loader->setSampleRate(sampleRate);
-        vst2Loader->setBlockSize(samplesPerBlock);
-        vst2Loader->resume();
+    if (engineLoader->isReady()) {
+        vst2Loader->suspend();
         
-        // FORCE 5.1 CONFIGURATION AFTER RESUME
-        auto* effect = vst2Loader->getEffect();
-        if (effect) {
-            // Force 6 channels
-            effect->numInputs = 6;
-            effect->numOutputs = 6;
-            
-            // Setup 5.1 speaker arrangements
-            VstSpeakerArrangement inputs, outputs;
-            inputs.type = kSpeakerArr51;
-            inputs.numChannels = 6;
-            outputs.type = kSpeakerArr51;
-            outputs.numChannels = 6;
-            
-            // Try setting speaker arrangement
-            effect->dispatcher(effect, effSetSpeakerArrangement, 0, 
-                              (VstIntPtr)&inputs, &outputs, 0.0f);
+        for (int group = 1; group < numEngineGroups; ++group) {
+            groupEngines[group - 1]->suspend();
         }
     }
 }
 
-void AltiverbSurroundProcessor::releaseResources() {
-    if (pluginLoaded) {
-        vst2Loader->suspend();
+void AltiverbSurroundProcessor::setConstantBlockModeEnabled(bool shouldBeEnabled) {
+    if (constantBlockModeEnabled == shouldBeEnabled) {
+        return;
+    }
+    
+    constantBlockModeEnabled = shouldBeEnabled;
+    vst2Loader->markStateChanged();  // Saved with the project
+    
+    // Re-prepare so the FIFO buffers and reported latency follow the new mode
+    if (prepared) {
+        suspendProcessing(true);
+        releaseResources();
+        prepareToPlay(currentSampleRate, currentBlockSize);
+        suspendProcessing(false);
+    }
+}
+
+void AltiverbSurroundProcessor::setPipelinedModeEnabled(bool shouldBeEnabled) {
+    if (pipelinedModeEnabled == shouldBeEnabled) {
+        return;
+    }
+    
+    pipelinedModeEnabled = shouldBeEnabled;
+    vst2Loader->markStateChanged();  // Saved with the project
+    
+    // Re-prepare so the FIFO, engine thread and reported latency follow
+    if (prepared) {
+        suspendProcessing(true);
+        releaseResources();
+        prepareToPlay(currentSampleRate, currentBlockSize);
+        suspendProcessing(false);
+    }
+}
+
+ChannelRouting AltiverbSurroundProcessor::getChannelRouting() const {
+    const juce::ScopedLock sl(engineLock);
+    return channelRouting;
+}
+
+void AltiverbSurroundProcessor::setChannelRouting(const ChannelRouting& routing) {
+    {
+        const juce::ScopedLock sl(engineLock);
+        if (channelRouting == routing) {
+            return;
+        }
+        channelRouting = routing;
+    }
+    
+    vst2Loader->markStateChanged();  // Saved with the project
+    
+    // Re-prepare so the matrix, processing path and scratch buffers follow
+    if (prepared) {
+        suspendProcessing(true);
+        releaseResources();
+        prepareToPlay(currentSampleRate, currentBlockSize);
+        suspendProcessing(false);
     }
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool AltiverbSurroundProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const {
-    // Simple: only support 5.1 in and 5.1 out
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::create5point1())
-        return false;
+    // 5.1, 7.1 or 7.1.4 - the same on input and output
+    const auto inputSet = layouts.getMainInputChannelSet();
     
-    if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::create5point1())
+    if (layouts.getMainOutputChannelSet() != inputSet)
         return false;
     
-    return true;
+    return SpeakerLayout::find(inputSet) != nullptr;
 }
 #endif
 
-void AltiverbSurroundProcessor::mapInputChannels(const juce::AudioBuffer<float>& buffer) {
-    int numSamples = buffer.getNumSamples();
+const SpeakerLayout* AltiverbSurroundProcessor::chooseSpeakerLayout() const {
+    if (auto* layout = SpeakerLayout::find(getBusesLayout().getMainInputChannelSet())) {
+        return layout;
+    }
+    
+    return &SpeakerLayout::getDefault();
+}
+
+void AltiverbSurroundProcessor::prepareScratchArena(int samplesPerBlock) {
+    // The FIFO is the same offline as in real time, so a bounce reports the latency the
+    // host compensated for during playback. The render thread can wait, so offline the
+    // pipelined mode runs its FIFO blocks in place.
+    const bool pipelined = pipelinedModeEnabled && !offlineRendering;
+    const bool useFifo = constantBlockModeEnabled || pipelinedModeEnabled;
+    const int fifoBlockSize = samplesPerBlock;
+    
+    // Host maximum block size plus headroom, so slightly oversized blocks still fit -
+    // and at least the FIFO's blocks, which is also the block size Altiverb is told.
+    // Offline Altiverb is told a large block size instead, for large partitions, and
+    // large host blocks reach it whole.
+    maxChunkSize = ScratchArena::alignSamples(juce::jmax(samplesPerBlock + samplesPerBlock / 4, useFifo ? fifoBlockSize : 0,
+                                                         offlineRendering ? offlineBlockSize : 0));
+    
+    const size_t channelBytes = sizeof(float) * (size_t)maxChunkSize;
+    const int numChannels = speakerLayout->numChannels;
+    int numInputChannels = processingPath == ProcessingPath::inPlace ? 0 : numChannels;
+    int numOutputChannels = processingPath == ProcessingPath::mapped ? numChannels : 0;
+    
+    // The constant-block FIFO brings its own buffers, unless the routing needs copies
+    if (useFifo && processingPath != ProcessingPath::mapped) {
+        numInputChannels = 0;
+        numOutputChannels = 0;
+    }
+    
+    // Double-precision hosts: float copies for the converted path, input copies for the 64-bit engine
+    const bool doubleHost = isUsingDoublePrecision();
+    numConversionChannels = doubleHost ? juce::jmin(SpeakerLayout::maxChannels,
+                                                    juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels())) : 0;
+    const int numDoubleInputChannels = doubleHost && processingPath == ProcessingPath::zeroCopy ? numChannels : 0;
+    toFloat = ChannelKernels::getToFloatKernel();
+    toDouble = ChannelKernels::getToDoubleKernel();
     
-    for (int ch = 0; ch < 6 && ch < buffer.getNumChannels(); ++ch) {
-        internalInputBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+    scratchArena.beginLayout();
+    scheduler.reserve(scratchArena, useFifo, pipelined, numChannels, fifoBlockSize);
+    bypassDelay.reserve(scratchArena, numChannels,
+                        scheduler.getLatencySamples() + juce::jmax(pluginLatencySamples.load(), BypassDelay::defaultMaxDelay),
+                        maxChunkSize);
+    size_t inputPtrsOffset = scratchArena.reserveArray<float*>(SpeakerLayout::maxChannels);
+    size_t outputPtrsOffset = scratchArena.reserveArray<float*>(SpeakerLayout::maxChannels);
+    size_t inputOffsets[SpeakerLayout::maxChannels] = {};
+    size_t outputOffsets[SpeakerLayout::maxChannels] = {};
+    size_t doubleInputPtrsOffset = scratchArena.reserveArray<double*>(SpeakerLayout::maxChannels);
+    size_t doubleOutputPtrsOffset = scratchArena.reserveArray<double*>(SpeakerLayout::maxChannels);
+    size_t doubleInputOffsets[SpeakerLayout::maxChannels] = {};
+    size_t conversionOffsets[SpeakerLayout::maxChannels] = {};
+    
+    for (int ch = 0; ch < numInputChannels; ++ch) {
+        inputOffsets[ch] = scratchArena.reserve(channelBytes);
+    }
+    for (int ch = 0; ch < numOutputChannels; ++ch) {
+        outputOffsets[ch] = scratchArena.reserve(channelBytes);
+    }
+    for (int ch = 0; ch < numDoubleInputChannels; ++ch) {
+        doubleInputOffsets[ch] = scratchArena.reserveArray<double>((size_t)maxChunkSize);
+    }
+    for (int ch = 0; ch < numConversionChannels; ++ch) {
+        conversionOffsets[ch] = scratchArena.reserve(channelBytes);
     }
     
-    for (int ch = buffer.getNumChannels(); ch < 6; ++ch) {
-        internalInputBuffer.clear(ch, 0, numSamples);
+    scratchArena.allocate();
+    scheduler.attach(scratchArena);
+    bypassDelay.attach(scratchArena);
+    
+    inputChannelPtrs = scratchArena.getArray<float*>(inputPtrsOffset);
+    outputChannelPtrs = scratchArena.getArray<float*>(outputPtrsOffset);
+    
+    for (int ch = 0; ch < SpeakerLayout::maxChannels; ++ch) {
+        internalInputChannels[ch] = ch < numInputChannels ? scratchArena.getArray<float>(inputOffsets[ch]) : nullptr;
+        internalOutputChannels[ch] = ch < numOutputChannels ? scratchArena.getArray<float>(outputOffsets[ch]) : nullptr;
+    }
+    
+    doubleInputPtrs = scratchArena.getArray<double*>(doubleInputPtrsOffset);
+    doubleOutputPtrs = scratchArena.getArray<double*>(doubleOutputPtrsOffset);
+    
+    for (int ch = 0; ch < SpeakerLayout::maxChannels; ++ch) {
+        internalDoubleInputChannels[ch] = ch < numDoubleInputChannels ? scratchArena.getArray<double>(doubleInputOffsets[ch]) : nullptr;
+        conversionChannels[ch] = ch < numConversionChannels ? scratchArena.getArray<float>(conversionOffsets[ch]) : nullptr;
     }
 }
 
-void AltiverbSurroundProcessor::mapOutputChannels(juce::AudioBuffer<float>& buffer) {
-    int numSamples = buffer.getNumSamples();
+void AltiverbSurroundProcessor::mapInputChannels(const float* const* hostChannels, int numHostChannels, int numSamples) {
+    // Route, trim and invert in one pass per channel; silence where the host has no channel
+    for (int ch = 0; ch < routingMatrix.numChannels; ++ch) {
+        const auto& route = routingMatrix.inputs[ch];
+        
+        if (route.source >= 0 && route.source < numHostChannels) {
+            gainCopy(internalInputChannels[ch], hostChannels[route.source], route.gain, numSamples);
+        } else {
+            juce::FloatVectorOperations::clear(internalInputChannels[ch], numSamples);
+        }
+    }
+}
+
+void AltiverbSurroundProcessor::mapOutputChannels(float* const* hostChannels, int numHostChannels, int numSamples) {
+    for (int ch = 0; ch < juce::jmin(routingMatrix.numChannels, numHostChannels); ++ch) {
+        const auto& route = routingMatrix.outputs[ch];
+        
+        if (route.source >= 0) {
+            gainCopy(hostChannels[ch], internalOutputChannels[route.source], route.gain, numSamples);
+        } else {
+            juce::FloatVectorOperations::clear(hostChannels[ch], numSamples);
+        }
+    }
+}
+
+AltiverbSurroundProcessor::ProcessingPath AltiverbSurroundProcessor::chooseProcessingPath() {
+    // Identity routing: host channels are exactly the layout's. A differing channel
+    // order costs nothing - host channels are handed over in plugin order.
+    const int numChannels = speakerLayout->numChannels;
+    bool identityRouting = getTotalNumInputChannels() == numChannels && getTotalNumOutputChannels() == numChannels;
     
-    for (int ch = 0; ch < 6 && ch < buffer.getNumChannels(); ++ch) {
-        buffer.copyFrom(ch, 0, internalOutputBuffer, ch, 0, numSamples);
+    // Any routing, trim or inversion goes through the matrix
+    if (!identityRouting || !routingPassThrough) {
+        return ProcessingPath::mapped;
     }
+    
+    // Passing the same pointers as inputs and outputs is only safe for plugins that
+    // read each input sample before writing the output, so it is opt-in
+    if (loadFlagFromRegistry("ProcessInPlace")) {
+        return ProcessingPath::inPlace;
+    }
+    
+    return ProcessingPath::zeroCopy;
 }
 
 void AltiverbSurroundProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
     juce::ScopedNoDenormals noDenormals;
+    const RealtimeAudit::RealtimeSection realtimeSection;
     
+    renderInPieces(buffer, [this](juce::AudioBuffer<float>& piece) {
+        renderBlock(piece);
+    });
+}
+
+void AltiverbSurroundProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) {
+    juce::ScopedNoDenormals noDenormals;
+    const RealtimeAudit::RealtimeSection realtimeSection;
     
-    if (!pluginLoaded) {
-        // Simple passthrough mode
+    if (doublePrecisionEngine.load()) {
+        renderInPieces(buffer, [this](juce::AudioBuffer<double>& piece) {
+            renderBlock(piece);
+        });
         return;
     }
     
-    // Process with Altiverb
-    int numSamples = buffer.getNumSamples();
+    // Altiverb only takes floats here - run the float path on a converted copy
+    renderConverted(buffer, [this](juce::AudioBuffer<float>& floatBuffer) {
+        renderBlock(floatBuffer);
+    });
+}
+
+void AltiverbSurroundProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    juce::ScopedNoDenormals noDenormals;
+    const RealtimeAudit::RealtimeSection realtimeSection;
     
-    // Ensure buffers are the right size
-    if (internalInputBuffer.getNumSamples() < numSamples) {
-        internalInputBuffer.setSize(6, numSamples);
-        internalOutputBuffer.setSize(6, numSamples);
+    renderInPieces(buffer, [this](juce::AudioBuffer<float>& piece) {
+        renderBypassedBlock(piece);
+    });
+}
+
+void AltiverbSurroundProcessor::processBlockBypassed(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) {
+    juce::ScopedNoDenormals noDenormals;
+    const RealtimeAudit::RealtimeSection realtimeSection;
+    
+    if (doublePrecisionEngine.load()) {
+        renderInPieces(buffer, [this](juce::AudioBuffer<double>& piece) {
+            renderBypassedBlock(piece);
+        });
+        return;
+    }
+    
+    renderConverted(buffer, [this](juce::AudioBuffer<float>& floatBuffer) {
+        renderBypassedBlock(floatBuffer);
+    });
+}
+
+bool AltiverbSurroundProcessor::supportsDoublePrecisionProcessing() const {
+    // Native when Altiverb has a 64-bit path, converted in scratch memory otherwise
+    return true;
+}
+
+template <typename SampleType, typename RenderFn>
+void AltiverbSurroundProcessor::renderInPieces(juce::AudioBuffer<SampleType>& buffer, RenderFn&& render) {
+    // Host blocks over the prepared size are rendered a piece at a time, so the bypass
+    // delay and the scratch buffers never see more than they were sized for
+    if (buffer.getNumSamples() <= maxChunkSize) {
+        render(buffer);
+        return;
     }
     
-    // Map input channels
-    mapInputChannels(buffer);
+    SubBlockScheduler::forEachChunk(buffer.getNumSamples(), maxChunkSize, [&](int startSample, int numSamples) {
+        // Refers to the host's channels - no allocation for up to 32 of them
+        juce::AudioBuffer<SampleType> piece(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), startSample, numSamples);
+        renderSampleOffset = startSample;
+        render(piece);
+    });
+    
+    renderSampleOffset = 0;
+}
+
+template <typename RenderFn>
+void AltiverbSurroundProcessor::renderConverted(juce::AudioBuffer<double>& buffer, RenderFn&& render) {
+    // Pieces no larger than the scratch channels - oversized host blocks just take more than one
+    const int numChannels = juce::jmin(numConversionChannels, buffer.getNumChannels());
     
-    // Setup channel pointers for VST2 processing
-    for (int ch = 0; ch < 6; ++ch) {
-        inputChannelPtrs[ch] = internalInputBuffer.getWritePointer(ch);
-        outputChannelPtrs[ch] = internalOutputBuffer.getWritePointer(ch);
+    SubBlockScheduler::forEachChunk(buffer.getNumSamples(), maxChunkSize, [&](int startSample, int numSamples) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            toFloat(conversionChannels[ch], buffer.getReadPointer(ch, startSample), numSamples);
+        }
+        
+        conversionBuffer.setDataToReferTo(conversionChannels, numChannels, numSamples);
+        renderSampleOffset = startSample;
+        render(conversionBuffer);
+        
+        for (int ch = 0; ch < numChannels; ++ch) {
+            toDouble(buffer.getWritePointer(ch, startSample), conversionChannels[ch], numSamples);
+        }
+    });
+    
+    renderSampleOffset = 0;
+}
+
+template <typename SampleType>
+void AltiverbSurroundProcessor::renderBlock(juce::AudioBuffer<SampleType>& buffer) {
+    // The dry signal is kept for bypass on every block, so it stays aligned with the engine
+    bypassDelay.push(buffer);
+    
+    // Passthrough until the engine is published and while a state restore is running.
+    // engineInUse is raised before checking, so a restore can wait for this block to leave.
+    engineInUse.store(true);
+    
+    if (!engineLoader->isReady() || stateRestorer->isBusy()) {
+        engineInUse.store(false);
+        return;
+    }
+    
+    const auto blockStartTicks = juce::Time::getHighResolutionTicks();
+    updateEngineTimeInfo();
+    
+    // Leaving bypass: fade back in, once the timer has resumed a suspended engine
+    auto state = bypassState.load();
+    if (state == BypassState::bypassed) {
+        state = BypassState::resuming;
+        bypassState.store(state);
+    } else if (state == BypassState::fadingOut) {
+        // Engine still running - turn the fade around where it is
+        bypassFadePosition = bypassFadeLength - bypassFadePosition;
+        state = BypassState::fadingIn;
+        bypassState.store(state);
+    }
+    
+    if (state == BypassState::resuming) {
+        bypassDelay.readDelayed(buffer);
+    } else {
+        processEngineBlock(buffer);
+        
+        if (state == BypassState::fadingIn && advanceBypassFade(buffer, false)) {
+            bypassState.store(BypassState::engaged);
+        }
+    }
+    
+    engineInUse.store(false);
+    loadMetrics.recordBlock(juce::Time::getHighResolutionTicks() - blockStartTicks, buffer.getNumSamples());
+}
+
+void AltiverbSurroundProcessor::updateEngineTimeInfo() {
+    // The play head is asked once per host block, not per piece of it
+    if (renderSampleOffset == 0) {
+        auto* playHead = getPlayHead();
+        auto position = playHead != nullptr ? playHead->getPosition() : juce::Optional<juce::AudioPlayHead::PositionInfo>();
+        
+        hasBlockPosition = position.hasValue();
+        if (hasBlockPosition) {
+            blockPosition = *position;
+        }
+    }
+    
+    publishEngineTimeInfo(0);
+}
+
+void AltiverbSurroundProcessor::publishEngineTimeInfo(int startSample) {
+    // Audio thread, before the engines process from startSample of the current buffer
+    if (!hasBlockPosition) {
+        return;
+    }
+    
+    const int sampleOffset = renderSampleOffset + startSample;
+    vst2Loader->setTimeInfo(blockPosition, currentSampleRate, sampleOffset);
+    
+    for (int group = 1; group < numEngineGroups; ++group) {
+        groupEngines[group - 1]->setTimeInfo(blockPosition, currentSampleRate, sampleOffset);
+    }
+}
+
+template <typename SampleType>
+void AltiverbSurroundProcessor::renderBypassedBlock(juce::AudioBuffer<SampleType>& buffer) {
+    bypassDelay.push(buffer);
+    
+    engineInUse.store(true);
+    
+    if (!engineLoader->isReady() || stateRestorer->isBusy()) {
+        engineInUse.store(false);
+        bypassDelay.readDelayed(buffer);
+        return;
+    }
+    
+    const auto blockStartTicks = juce::Time::getHighResolutionTicks();
+    
+    // Entering bypass: run the engine through a short fade to the delayed dry signal
+    auto state = bypassState.load();
+    if (state == BypassState::engaged) {
+        bypassFadePosition = 0;
+        state = BypassState::fadingOut;
+        bypassState.store(state);
+    } else if (state == BypassState::fadingIn) {
+        bypassFadePosition = bypassFadeLength - bypassFadePosition;
+        state = BypassState::fadingOut;
+        bypassState.store(state);
+    } else if (state == BypassState::resuming) {
+        // Bypassed again before the engine came back
+        state = BypassState::bypassed;
+        bypassState.store(state);
+    }
+    
+    if (state == BypassState::fadingOut) {
+        processEngineBlock(buffer);
+        
+        // Fully dry - from here on the timer can suspend the engine
+        if (advanceBypassFade(buffer, true)) {
+            bypassState.store(BypassState::bypassed);
+        }
+    } else {
+        bypassDelay.readDelayed(buffer);
+    }
+    
+    engineInUse.store(false);
+    loadMetrics.recordBlock(juce::Time::getHighResolutionTicks() - blockStartTicks, buffer.getNumSamples());
+}
+
+template <typename SampleType>
+void AltiverbSurroundProcessor::processEngineBlock(juce::AudioBuffer<SampleType>& buffer) {
+    // Idle return: once the tail has died out, skip Altiverb until any input comes back
+    if (!silenceGate.shouldProcess(buffer, speakerLayout->numChannels)) {
+        buffer.clear();
+        return;
+    }
+    
+    processEngineChunks(buffer);
+    
+    // Gone to sleep: nothing may be left in the FIFO to play out stale on waking.
+    // It only holds silence by now, so clearing it is inaudible.
+    if (silenceGate.blockProcessed(buffer, speakerLayout->numChannels) && scheduler.isConstantBlockMode()) {
+        enginePipeline.waitForBlock();
+        scheduler.reset();
+    }
+}
+
+void AltiverbSurroundProcessor::processEngineChunks(juce::AudioBuffer<float>& buffer) {
+    if (scheduler.isPipelined() && enginePipeline.isRunning()) {
+        // Pipelined: the engine thread works on one block while the next is buffered
+        scheduler.processPipelinedBlocks(buffer,
+                                         [this] { enginePipeline.waitForBlock(); },
+                                         [this](float** inputs, float** outputs, int blockSize) {
+                                             enginePipeline.submit(inputs, outputs, blockSize);
+                                         });
+    } else if (scheduler.isConstantBlockMode()) {
+        // Constant-block mode: Altiverb only ever sees full, equally sized blocks
+        scheduler.processConstantBlocks(buffer, [this](float** inputs, float** outputs, int blockSize) {
+            processFifoBlock(inputs, outputs, blockSize);
+        });
+    } else {
+        // Process with Altiverb - host blocks are split into chunks no larger than the prepared size
+        SubBlockScheduler::forEachChunk(buffer.getNumSamples(), maxChunkSize, [&](int startSample, int numSamples) {
+            if (startSample > 0) {
+                publishEngineTimeInfo(startSample);
+            }
+            processChunk(buffer, startSample, numSamples);
+        });
+    }
+}
+
+void AltiverbSurroundProcessor::processFifoBlock(float** inputs, float** outputs, int blockSize) {
+    // The FIFO holds host order - hand its channels over in plugin order
+    if (processingPath == ProcessingPath::mapped) {
+        mapInputChannels(inputs, speakerLayout->numChannels, blockSize);
+        processEngine(internalInputChannels, internalOutputChannels, blockSize);
+        mapOutputChannels(outputs, speakerLayout->numChannels, blockSize);
+        return;
+    }
+    
+    for (int ch = 0; ch < speakerLayout->numChannels; ++ch) {
+        const int hostChannel = speakerLayout->speakers[ch].hostChannel;
+        inputChannelPtrs[ch] = inputs[hostChannel];
+        outputChannelPtrs[ch] = outputs[hostChannel];
+    }
+    processEngine(inputChannelPtrs, outputChannelPtrs, blockSize);
+}
+
+void AltiverbSurroundProcessor::processEngineChunks(juce::AudioBuffer<double>& buffer) {
+    // The 64-bit engine is only used without the FIFO
+    SubBlockScheduler::forEachChunk(buffer.getNumSamples(), maxChunkSize, [&](int startSample, int numSamples) {
+        if (startSample > 0) {
+            publishEngineTimeInfo(startSample);
+        }
+        processChunk(buffer, startSample, numSamples);
+    });
+}
+
+template <typename SampleType>
+bool AltiverbSurroundProcessor::advanceBypassFade(juce::AudioBuffer<SampleType>& buffer, bool towardsDry) {
+    // Returns true once the fade is complete
+    const int numSamples = buffer.getNumSamples();
+    const float start = (float)bypassFadePosition / (float)bypassFadeLength;
+    bypassFadePosition = juce::jmin(bypassFadePosition + numSamples, bypassFadeLength);
+    const float end = (float)bypassFadePosition / (float)bypassFadeLength;
+    
+    if (towardsDry) {
+        bypassDelay.mixDelayed(buffer, start, end);
+    } else {
+        bypassDelay.mixDelayed(buffer, 1.0f - start, 1.0f - end);
+    }
+    
+    return bypassFadePosition >= bypassFadeLength;
+}
+
+void AltiverbSurroundProcessor::updateBypassedEngine() {
+    // Message thread - suspend a bypassed engine, resume it when the host re-engages
+    const auto state = bypassState.load();
+    if (state != BypassState::bypassed && state != BypassState::resuming) {
+        return;
+    }
+    
+    const juce::ScopedLock sl(engineLock);
+    
+    if (!engineLoader->isReady() || !prepared) {
+        return;
+    }
+    
+    if (state == BypassState::bypassed && !engineSuspendedForBypass) {
+        // effMainsChanged(0) - the audio thread no longer calls the engine, once a
+        // pipelined block still in flight is done
+        enginePipeline.waitForBlock();
+        vst2Loader->suspend();
+        for (int group = 1; group < numEngineGroups; ++group) {
+            groupEngines[group - 1]->suspend();
+        }
+        engineSuspendedForBypass = true;
+    } else if (state == BypassState::resuming) {
+        if (engineSuspendedForBypass) {
+            for (int group = 0; group < numEngineGroups; ++group) {
+                auto& engine = group == 0 ? *vst2Loader : *groupEngines[group - 1];
+                engine.setSampleRate(currentSampleRate);
+                engine.setBlockSize(maxChunkSize);
+                engine.resume();
+            }
+            engineSuspendedForBypass = false;
+        }
+        
+        // Unless the host bypassed again meanwhile, fade the engine back in.
+        // The audio thread doesn't touch the fade position while resuming.
+        bypassFadePosition = 0;
+        auto expected = BypassState::resuming;
+        bypassState.compare_exchange_strong(expected, BypassState::fadingIn);
+    }
+}
+
+void AltiverbSurroundProcessor::updateLatency() {
+    // Altiverb's latency plus the constant-block FIFO
+    const int latency = scheduler.getLatencySamples() + pluginLatencySamples.load();
+    bypassDelay.setDelay(latency);
+    silenceGate.setLatencySamples(latency);
+    setLatencySamples(latency);
+}
+
+template <typename SampleType>
+void AltiverbSurroundProcessor::processEngine(SampleType** inputs, SampleType** outputs, int numSamples) {
+    // A block that raced the engine being configured for the other precision is left as it is
+    if (doublePrecisionEngine.load() != std::is_same_v<SampleType, double>) {
+        return;
+    }
+    
+    // Parameter changes land on sub-block boundaries, coalesced over the apply interval
+    if (samplesSinceParameterApply >= parameterApplyInterval && (parameterQueue.hasPending() || mirrorQueue.hasPending())) {
+        applyParameterChanges();
+        samplesSinceParameterApply = 0;
+    }
+    samplesSinceParameterApply = juce::jmin(samplesSinceParameterApply + numSamples, parameterApplyInterval);
+    
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    if constexpr (std::is_same_v<SampleType, double>) {
+        vst2Loader->processDoubleReplacing(inputs, outputs, numSamples);
+    } else if (numEngineGroups > 1) {
+        processEngineGroups(inputs, outputs, numSamples);
+    } else {
+        vst2Loader->processReplacing(inputs, outputs, numSamples);
+    }
+    loadMetrics.recordCall(juce::Time::getHighResolutionTicks() - startTicks);
+}
+
+void AltiverbSurroundProcessor::processEngineGroups(float** inputs, float** outputs, int numSamples) {
+    // Channels are in plugin order and groups are contiguous, so each engine gets a
+    // slice of the same pointer tables. Returns once every group has been processed.
+    auto processGroup = [&](int group) {
+        const int firstChannel = speakerLayout->groups[group].firstChannel;
+        auto& engine = group == 0 ? *vst2Loader : *groupEngines[group - 1];
+        engine.processReplacing(inputs + firstChannel, outputs + firstChannel, numSamples);
+    };
+    
+    workerPool.run(numEngineGroups, processGroup);
+}
+
+void AltiverbSurroundProcessor::processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) {
+    const int numChannels = speakerLayout->numChannels;
+    const int numHostChannels = juce::jmin(SpeakerLayout::maxChannels, buffer.getNumChannels());
+    float* hostChannels[SpeakerLayout::maxChannels] = {};
+    
+    switch (processingPath) {
+        case ProcessingPath::inPlace:
+            // Hand host channels straight to the plugin, in plugin order
+            for (int ch = 0; ch < numChannels; ++ch) {
+                inputChannelPtrs[ch] = buffer.getWritePointer(speakerLayout->speakers[ch].hostChannel, startSample);
+                outputChannelPtrs[ch] = inputChannelPtrs[ch];
+            }
+            break;
+            
+        case ProcessingPath::zeroCopy: {
+            // Inputs come from the scratch copy, outputs go straight to the host
+            const float* hostInputs[SpeakerLayout::maxChannels];
+            
+            for (int ch = 0; ch < numChannels; ++ch) {
+                const int hostChannel = speakerLayout->speakers[ch].hostChannel;
+                hostInputs[ch] = buffer.getReadPointer(hostChannel, startSample);
+                inputChannelPtrs[ch] = internalInputChannels[ch];
+                outputChannelPtrs[ch] = buffer.getWritePointer(hostChannel, startSample);
+            }
+            
+            copyChannels(internalInputChannels, hostInputs, numSamples);
+            break;
+        }
+            
+        case ProcessingPath::mapped:
+            // Map input channels
+            for (int ch = 0; ch < numHostChannels; ++ch) {
+                hostChannels[ch] = buffer.getWritePointer(ch, startSample);
+            }
+            mapInputChannels(hostChannels, numHostChannels, numSamples);
+            
+            // Setup channel pointers for VST2 processing
+            for (int ch = 0; ch < numChannels; ++ch) {
+                inputChannelPtrs[ch] = internalInputChannels[ch];
+                outputChannelPtrs[ch] = internalOutputChannels[ch];
+            }
+            break;
     }
     
     // Process through VST2
     if (vst2Loader && vst2Loader->getEffect()) {
-        vst2Loader->processReplacing(inputChannelPtrs.data(), outputChannelPtrs.data(), numSamples);
+        processEngine(inputChannelPtrs, outputChannelPtrs, numSamples);
     }
     
     // Map output channels back
-    mapOutputChannels(buffer);
+    if (processingPath == ProcessingPath::mapped) {
+        mapOutputChannels(hostChannels, numHostChannels, numSamples);
+    }
+}
+
+void AltiverbSurroundProcessor::processChunk(juce::AudioBuffer<double>& buffer, int startSample, int numSamples) {
+    // Altiverb's 64-bit path - only chosen with pass-through routing, so there is no matrix to apply
+    if (processingPath == ProcessingPath::mapped) {
+        jassertfalse;
+        return;
+    }
+    
+    for (int ch = 0; ch < speakerLayout->numChannels; ++ch) {
+        double* hostChannel = buffer.getWritePointer(speakerLayout->speakers[ch].hostChannel, startSample);
+        
+        if (processingPath == ProcessingPath::inPlace) {
+            doubleInputPtrs[ch] = hostChannel;
+        } else {
+            juce::FloatVectorOperations::copy(internalDoubleInputChannels[ch], hostChannel, numSamples);
+            doubleInputPtrs[ch] = internalDoubleInputChannels[ch];
+        }
+        doubleOutputPtrs[ch] = hostChannel;
+    }
+    
+    if (vst2Loader && vst2Loader->getEffect()) {
+        processEngine(doubleInputPtrs, doubleOutputPtrs, numSamples);
+    }
 }
 
 bool AltiverbSurroundProcessor::hasEditor() const {
@@ -197,144 +1214,242 @@ juce::AudioProcessorEditor* AltiverbSurroundProcessor::createEditor() {
 }
 
 void AltiverbSurroundProcessor::getStateInformation(juce::MemoryBlock& destData) {
+    {
+        const juce::ScopedLock sl(engineLock);
+        
+        // Still loading or restoring - hand back the state we were given rather than a stale one
+        if (pendingState.getSize() > 0) {
+            destData = pendingState;
+            return;
+        }
+    }
+    
+    // Nothing changed since the last snapshot - no calls into Altiverb at all
+    if (snapshotCache->getIfCurrent(destData)) {
+        return;
+    }
+    
+    if (snapshotCache->refresh(destData)) {
+        return;
+    }
     
-    // Create XML to store our wrapper state + VST2 state
-    std::unique_ptr<juce::XmlElement> xml(new juce::XmlElement("AltiverbSurroundWrapperState"));
+    // Not cacheable (bridged engine, or a state arrived meanwhile). Only reading
+    // the engine holds the lock - the container is written after it is released.
+    WrapperState state;
+    {
+        const juce::ScopedLock sl(engineLock);
+        
+        if (pendingState.getSize() > 0) {
+            destData = pendingState;
+            return;
+        }
+        
+        collectState(state);
+    }
     
-    // Always save basic wrapper state
-    xml->setAttribute("version", "1.1.0");
-    xml->setAttribute("pluginLoaded", pluginLoaded ? "true" : "false");
+    StateContainer::write(state, destData);
+}
+
+bool AltiverbSurroundProcessor::takeSnapshot(juce::MemoryBlock& destData) {
+    // Host thread or the snapshot thread
+    WrapperState state;
+    {
+        const juce::ScopedLock sl(engineLock);
+        
+        // A pending state is returned as-is, and bridged changes can't be tracked
+        if (pendingState.getSize() > 0 || !vst2Loader->canTrackStateChanges()) {
+            return false;
+        }
+        
+        collectState(state);
+    }
     
-    // Save VST2 path for this project
-    juce::String currentPath = getVST2Path();
-    xml->setAttribute("vst2Path", currentPath);
+    StateContainer::write(state, destData);
+    return true;
+}
+
+void AltiverbSurroundProcessor::collectState(WrapperState& state) {
+    // Engine lock held
+    // Wrapper settings
+    state.vst2Path = getVST2Path();
+    state.constantBlockMode = constantBlockModeEnabled;
+    state.splitEngines = engineSplitEnabled;
+    state.pipelined = pipelinedModeEnabled;
+    state.routing = channelRouting;
+    state.engineLoaded = engineLoader->isReady();
     
     // Get state from loaded Altiverb VST2 plugin
-    if (pluginLoaded && vst2Loader) {
-        auto* effect = vst2Loader->getEffect();
-        if (effect) {
-            bool supportsChunks = (effect->flags & effFlagsProgramChunks) != 0;
-            int numParams = vst2Loader->getNumParameters();
-            
-            
-            // Hybrid approach: Save BOTH chunks and parameters for maximum reliability
-            bool chunkSaved = false;
-            if (supportsChunks) {
-                void* chunkData = nullptr;
-                int chunkSize = vst2Loader->getChunk(&chunkData, false);
-                if (chunkSize > 0 && chunkData != nullptr) {
-                    juce::MemoryBlock vstState(chunkData, chunkSize);
-                    juce::String encodedState = vstState.toBase64Encoding();
-                    xml->setAttribute("vstState", encodedState);
-                    xml->setAttribute("chunkSize", chunkSize);
-                    chunkSaved = true;
-                }
-            }
-            
-            // ALWAYS save individual parameters as backup (even with chunks)
-            if (numParams > 0) {
-                juce::XmlElement* paramsXml = xml->createNewChildElement("Parameters");
-                for (int i = 0; i < numParams; ++i) {
-                    float value = vst2Loader->getParameter(i);
-                    paramsXml->setAttribute("param" + juce::String(i), value);
-                }
-                // Also save current program
-                paramsXml->setAttribute("currentProgram", vst2Loader->getCurrentProgram());
-                
-            }
+    if (engineLoader->isReady()) {
+        captureEngineState(state);
+    }
+}
+
+void AltiverbSurroundProcessor::captureEngineState(WrapperState& state) {
+    // Engine lock held - chunk and parameters of the first engine
+    state.chunk.reset();
+    state.hasParameters = false;
+    state.parameters.clearQuick();
+    
+    auto* effect = vst2Loader->getEffect();
+    if (!effect) {
+        return;
+    }
+    
+    // Hybrid approach: Save BOTH chunks and parameters for maximum reliability
+    if ((effect->flags & effFlagsProgramChunks) != 0) {
+        void* chunkData = nullptr;
+        int chunkSize = vst2Loader->getChunk(&chunkData, false);
+        if (chunkSize > 0 && chunkData != nullptr) {
+            state.chunk.replaceAll(chunkData, (size_t)chunkSize);
         }
     }
     
-    // Convert XML to memory block
-    copyXmlToBinary(*xml, destData);
+    // ALWAYS save individual parameters as backup (even with chunks)
+    int numParams = vst2Loader->getNumParameters();
+    if (numParams > 0) {
+        state.hasParameters = true;
+        state.currentProgram = vst2Loader->getCurrentProgram();
+        state.parameters.ensureStorageAllocated(numParams);
+        for (int i = 0; i < numParams; ++i) {
+            state.parameters.add(vst2Loader->getParameter(i));
+        }
+    }
 }
 
 void AltiverbSurroundProcessor::setStateInformation(const void* data, int sizeInBytes) {
     
     if (sizeInBytes == 0) return;
     
-    // Parse XML from memory block
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml == nullptr) return;
+    // Binary container, or the XML written by v1.0/v1.1
+    WrapperState state;
+    if (!StateContainer::read(data, sizeInBytes, state)) return;
+    
+    // Restore wrapper options, then re-prepare once for all of them - the
+    // setters would each re-prepare on their own
+    bool optionsChanged = constantBlockModeEnabled != state.constantBlockMode
+                       || engineSplitEnabled != state.splitEngines
+                       || pipelinedModeEnabled != state.pipelined;
+    
+    constantBlockModeEnabled = state.constantBlockMode;
+    engineSplitEnabled = state.splitEngines;
+    pipelinedModeEnabled = state.pipelined;
+    
+    {
+        const juce::ScopedLock sl(engineLock);
+        optionsChanged = optionsChanged || channelRouting != state.routing;
+        channelRouting = state.routing;
+    }
+    
+    if (optionsChanged) {
+        vst2Loader->markStateChanged();
+    }
+    
+    if (optionsChanged && prepared) {
+        suspendProcessing(true);
+        releaseResources();
+        prepareToPlay(currentSampleRate, currentBlockSize);
+        suspendProcessing(false);
+    }
+    
+    const juce::ScopedLock sl(engineLock);
+    
+    // The snapshot describes the state being replaced
+    snapshotCache->invalidate();
+    
+    // Keep the newest state and return straight away - it is restored in the
+    // background, or by the loader once the engine is ready
+    pendingState.replaceAll(data, (size_t)sizeInBytes);
+    
+    if (engineLoader->isReady()) {
+        stateRestorer->schedule();
+        return;
+    }
     
-    // Restore VST2 path for this project
-    if (xml->hasAttribute("vst2Path")) {
-        juce::String projectVst2Path = xml->getStringAttribute("vst2Path");
+    if (!engineLoader->isLoading()) {
+        // Prefer the VST2 path saved with this project
+        juce::String projectVst2Path = state.vst2Path;
+        if (!juce::File(projectVst2Path).existsAsFile()) {
+            projectVst2Path = getVST2Path();
+        }
         
-        // Try to load the VST2 plugin with the saved path
         if (juce::File(projectVst2Path).existsAsFile()) {
-            // Load the VST2 plugin if not already loaded
-            if (!pluginLoaded && vst2Loader) {
-                if (vst2Loader->loadPlugin(projectVst2Path.toUTF8())) {
-                    pluginLoaded = true;
-                    
-                    // Setup audio processing
-                    if (currentSampleRate > 0) {
-                        vst2Loader->setSampleRate(currentSampleRate);
-                        vst2Loader->setBlockSize(currentBlockSize);
-                        vst2Loader->resume();
-                    }
-                }
-            }
+            startEngineLoad(projectVst2Path);
         }
     }
+}
+
+void AltiverbSurroundProcessor::restoreEngineState(VST2Loader& engine, const WrapperState& state) {
+    // Restore VST2 plugin state (presets, parameters) - engine lock held, audio kept out
+    auto* effect = engine.getEffect();
+    if (!effect) {
+        return;
+    }
     
-    // Restore VST2 plugin state (presets, parameters)
-    if (pluginLoaded && vst2Loader) {
-        auto* effect = vst2Loader->getEffect();
-        if (effect) {
-            // Hybrid restoration: Try chunks first, then ALWAYS restore parameters as well
-            bool chunkRestored = false;
-            if (xml->hasAttribute("vstState") && (effect->flags & effFlagsProgramChunks)) {
-                juce::String encodedState = xml->getStringAttribute("vstState");
-                juce::MemoryBlock vstState;
-                vstState.fromBase64Encoding(encodedState);
-                
-                if (vstState.getSize() > 0) {
-                    if (vst2Loader->setChunk(vstState.getData(), (int)vstState.getSize(), false)) {
-                        chunkRestored = true;
-                        // Give plugin time to process chunk
-                        juce::Thread::sleep(50);
-                    }
-                }
-            }
-            
-            // ALWAYS restore parameters as well (even if chunks worked)
-            if (auto* paramsXml = xml->getChildByName("Parameters")) {
-                // Step 1: Restore current program first
-                if (paramsXml->hasAttribute("currentProgram")) {
-                    int program = paramsXml->getIntAttribute("currentProgram", 0);
-                    vst2Loader->setCurrentProgram(program);
-                    
-                    // Give plugin time to process program change
-                    juce::Thread::sleep(10);
-                }
-                
-                // Step 2: Suspend plugin before parameter restore
-                vst2Loader->suspend();
-                
-                // Step 3: Restore all parameters
-                int numParams = vst2Loader->getNumParameters();
-                int restoredCount = 0;
-                for (int i = 0; i < numParams; ++i) {
-                    juce::String paramName = "param" + juce::String(i);
-                    if (paramsXml->hasAttribute(paramName)) {
-                        float value = (float)paramsXml->getDoubleAttribute(paramName, 0.0);
-                        vst2Loader->setParameter(i, value);
-                        restoredCount++;
-                    }
-                }
-                
-                // Step 4: Resume plugin after parameter restore
-                if (currentSampleRate > 0) {
-                    vst2Loader->setSampleRate(currentSampleRate);
-                    vst2Loader->setBlockSize(currentBlockSize);
-                }
-                vst2Loader->resume();
-                
-            }
+    // One suspend/resume around the whole restore. setChunk, setProgram and
+    // setParameter are synchronous dispatcher calls, so no settling delays are needed.
+    engine.suspend();
+    
+    // Hybrid restoration: Try chunks first, then ALWAYS restore parameters as well
+    if (state.chunk.getSize() > 0 && (effect->flags & effFlagsProgramChunks)) {
+        engine.setChunk(const_cast<void*>(state.chunk.getData()), (int)state.chunk.getSize(), false);
+    }
+    
+    // ALWAYS restore parameters as well (even if chunks worked)
+    if (state.hasParameters) {
+        // Restore current program first
+        engine.setCurrentProgram(state.currentProgram);
+        
+        // Then all parameters
+        int numParams = juce::jmin(engine.getNumParameters(), state.parameters.size());
+        for (int i = 0; i < numParams; ++i) {
+            engine.setParameter(i, state.parameters[i]);
         }
     }
+    
+    // Only resume if the host has prepared us - prepareToPlay resumes otherwise.
+    // A bypassed engine stays suspended until the host re-engages.
+    if (prepared && !engineSuspendedForBypass) {
+        engine.setSampleRate(currentSampleRate);
+        engine.setBlockSize(maxChunkSize);
+        engine.resume();
+    }
+}
+
+void AltiverbSurroundProcessor::applyPendingState() {
+    // Engine lock held
+    WrapperState state;
+    bool parsed = StateContainer::read(pendingState.getData(), (int)pendingState.getSize(), state);
+    pendingState.reset();
+    
+    if (parsed) {
+        restoreEngineState(*vst2Loader, state);
+        mirrorStateToGroupEngines();
+    }
+    
+    syncParametersFromEngine();
+}
+
+void AltiverbSurroundProcessor::runPendingRestore() {
+    // Restore pool thread
+    const juce::ScopedLock sl(engineLock);
+    
+    // Still loading - onEngineLoaded applies the state instead
+    const bool syncGroups = groupSyncRequested.exchange(false);
+    if (!engineLoader->isReady() || (pendingState.getSize() == 0 && !syncGroups)) {
+        return;
+    }
+    
+    // The audio thread has seen the restorer busy; wait for a block already inside the engine
+    while (engineInUse.load() || enginePipeline.isBusy()) {
+        juce::Thread::yield();
+    }
+    
+    // A restored state reaches the group engines as well
+    if (pendingState.getSize() > 0) {
+        applyPendingState();
+    } else {
+        mirrorStateToGroupEngines();
+    }
 }
 
 // VST2 Path Configuration Methods
@@ -366,6 +1481,11 @@ juce::String AltiverbSurroundProcessor::getVST2Path() {
 }
 
 void AltiverbSurroundProcessor::saveVST2Path(const juce::String& path) {
+    // The path is saved with the project
+    if (path != loadVST2PathFromRegistry()) {
+        vst2Loader->markStateChanged();
+    }
+    
     #ifdef _WIN32
     // Save to Windows Registry
     HKEY hKey;
@@ -411,6 +1531,31 @@ juce::String AltiverbSurroundProcessor::loadVST2PathFromRegistry() {
     return juce::String();
 }
 
+bool AltiverbSurroundProcessor::loadFlagFromRegistry(const char* valueName) {
+    #ifdef _WIN32
+    HKEY hKey;
+    LONG result = RegOpenKeyExA(HKEY_CURRENT_USER, 
+                               "SOFTWARE\\AltiverbWrapper", 
+                               0, KEY_READ, &hKey);
+    
+    if (result == ERROR_SUCCESS) {
+        DWORD value = 0;
+        DWORD valueSize = sizeof(value);
+        DWORD type;
+        
+        result = RegQueryValueExA(hKey, valueName, NULL, &type, 
+                                 (BYTE*)&value, &valueSize);
+        RegCloseKey(hKey);
+        
+        if (result == ERROR_SUCCESS && type == REG_DWORD) {
+            return value != 0;
+        }
+    }
+    #endif
+    
+    return false;
+}
+
 // This creates new instances of the plugin
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter() {
     return new AltiverbSurroundProcessor();
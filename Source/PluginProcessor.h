@@ -1,8 +1,24 @@
 #pragma once
 #include <JuceHeader.h>
 #include "VST2Loader.h"
+#include "ScratchArena.h"
+#include "SubBlockScheduler.h"
+#include "DspLoadMetrics.h"
+#include "SilenceGate.h"
+#include "BypassDelay.h"
+#include "AsyncEngineLoader.h"
+#include "StateRestorer.h"
+#include "StateContainer.h"
+#include "StateSnapshotCache.h"
+#include "EngineParameters.h"
+#include "SpeakerLayout.h"
+#include "ChannelKernels.h"
+#include "ChannelRouting.h"
+#include "EngineWorkerPool.h"
+#include "EnginePipeline.h"
 
-class AltiverbSurroundProcessor : public juce::AudioProcessor
+class AltiverbSurroundProcessor : public juce::AudioProcessor,
+                                  private juce::Timer
 {
 public:
     AltiverbSurroundProcessor();
@@ -16,6 +32,10 @@ public:
     #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -39,23 +59,167 @@ public:
     // VST2 access for working version
     VST2Loader* getVST2Loader() { return vst2Loader.get(); }
     
+    // Engine readiness - the loader must not be used until this is true
+    AsyncEngineLoader::State getEngineState() const { return engineLoader->getState(); }
+    bool isEngineReady() const { return engineLoader->isReady(); }
+    
     // VST2 path configuration access
     juce::String getVST2Path();
     void saveVST2Path(const juce::String& path);
+    
+    // Load an engine and wait for it, before the first prepareToPlay (AltiverbBench)
+    bool loadEngineAndWait(const juce::String& path);
+    
+    // Constant-block FIFO mode - Altiverb always gets full blocks, one block of latency
+    bool isConstantBlockModeEnabled() const { return constantBlockModeEnabled; }
+    void setConstantBlockModeEnabled(bool shouldBeEnabled);
+    
+    // Pipelined mode - Altiverb runs one block behind on its own thread, one block of latency
+    bool isPipelinedModeEnabled() const { return pipelinedModeEnabled; }
+    void setPipelinedModeEnabled(bool shouldBeEnabled);
+    
+    // Split engines - one Altiverb per channel group, run in parallel on worker threads.
+    // Each group reverberates only its own inputs.
+    bool isEngineSplitEnabled() const { return engineSplitEnabled; }
+    void setEngineSplitEnabled(bool shouldBeEnabled);
+    int getNumActiveEngines() const { return numEngineGroups; }
+    
+    // DSP load of this instance - safe to call from any thread
+    DspLoadMetrics::Snapshot getDspLoadSnapshot() const { return loadMetrics.getSnapshot(); }
+    void resetDspLoadMetrics() { loadMetrics.reset(); }
+    
+    // True while the engine is skipped because input and tail are silent
+    bool isEngineAsleep() const { return silenceGate.isAsleep(); }
+    
+    // Channel order, trim and polarity (message thread) - saved with the project
+    ChannelRouting getChannelRouting() const;
+    void setChannelRouting(const ChannelRouting& routing);
+    const SpeakerLayout& getSpeakerLayout() const { return *speakerLayout; }
 
 private:
     std::unique_ptr<VST2Loader> vst2Loader;
     
-    // VST3 parameters (required for state management)
-    juce::AudioParameterFloat* dummyParam;
+    // Background loading; engineLock serialises engine setup, state and prepare/release
+    juce::CriticalSection engineLock;
+    std::unique_ptr<AsyncEngineLoader> engineLoader;
+    juce::MemoryBlock pendingState;  // Newest host state not yet applied to the engine
+    
+    // Session restore runs off the host thread; audio passes through meanwhile
+    std::unique_ptr<StateRestorer> stateRestorer;
+    std::atomic<bool> engineInUse { false };  // Audio thread is past the readiness check
+    
+    // Last serialized state, re-serialized in the background after changes
+    std::unique_ptr<StateSnapshotCache> snapshotCache;
+    
+    // Altiverb's parameters as host parameters (owned by the AudioProcessor).
+    // Changes reach the engine through the queue, on the audio thread.
+    juce::Array<EngineParameter*> engineParameters;
+    ParameterChangeQueue parameterQueue;
+    static constexpr double parameterApplyIntervalSeconds = 0.005;
+    int parameterApplyInterval = 240;     // Samples
+    int samplesSinceParameterApply = 0;   // Audio thread
+    
+    // Edits from Altiverb's editor, forwarded to the host once per UI frame (message thread)
+    static constexpr int editForwardingHz = 60;
+    float editedValues[ParameterChangeQueue::maxParameters] = {};
+    bool valueEdited[ParameterChangeQueue::maxParameters] = {};
+    bool gestureOpen[ParameterChangeQueue::maxParameters] = {};
+    
+    // Audio thread scratch memory - one arena, sized in prepareToPlay
+    ScratchArena scratchArena;
+    float** inputChannelPtrs = nullptr;
+    float** outputChannelPtrs = nullptr;
+    float* internalInputChannels[SpeakerLayout::maxChannels] = {};
+    float* internalOutputChannels[SpeakerLayout::maxChannels] = {};
+    int maxChunkSize = 512;  // Scratch capacity, also the block size Altiverb is prepared for
+    
+    // Double-precision hosts: Altiverb's own 64-bit path when it has one and nothing in
+    // between needs floats, otherwise the float path on a copy converted in scratch
+    std::atomic<bool> doublePrecisionEngine { false };
+    double** doubleInputPtrs = nullptr;
+    double** doubleOutputPtrs = nullptr;
+    double* internalDoubleInputChannels[SpeakerLayout::maxChannels] = {};
+    float* conversionChannels[SpeakerLayout::maxChannels] = {};
+    int numConversionChannels = 0;
+    juce::AudioBuffer<float> conversionBuffer;  // Refers to conversionChannels, never allocates
+    int renderSampleOffset = 0;  // Audio thread - where the piece being rendered starts in the host block
+    
+    // Audio thread - the host block's transport, for the engines' audioMasterGetTime
+    juce::AudioPlayHead::PositionInfo blockPosition;
+    bool hasBlockPosition = false;
+    ChannelKernels::ToFloatFn toFloat = nullptr;
+    ChannelKernels::ToDoubleFn toDouble = nullptr;
+    
+    // Split engines: vst2Loader runs the first group and stays the engine the editor,
+    // parameters and state talk to. The group engines mirror it.
+    bool engineSplitEnabled = false;
+    int numEngineGroups = 1;  // Engine lock; set in configureEngine, before the engine is used
+    std::unique_ptr<VST2Loader> groupEngines[SpeakerLayout::maxGroups - 1];
+    std::unique_ptr<AsyncEngineLoader> groupLoaders[SpeakerLayout::maxGroups - 1];  // Load them off the host's threads
+    int wantedEngineGroups = 1;                     // Engine lock
+    std::atomic<bool> groupEnginesLoaded { false }; // The full set is ready - the timer re-prepares to split
+    EngineWorkerPool workerPool;
+    ParameterChangeQueue mirrorQueue;  // Edits made in Altiverb's editor, for the group engines
+    std::atomic<bool> groupSyncRequested { false };
+    std::atomic<bool> groupEnginesDirty { false };  // Program or IR changed; synced from the timer
+    static constexpr int groupSyncIntervalMs = 100;
+    juce::uint32 lastGroupSyncTime = 0;  // Message thread
+    WrapperState mirroredState;        // Engine lock - what the group engines were last given
+    
+    // Splits host blocks into engine-sized chunks, or runs the constant-block FIFO
+    SubBlockScheduler scheduler;
+    bool constantBlockModeEnabled = false;
+    bool prepared = false;
+    
+    // Offline rendering (bounce, freeze), from isNonRealtime() in prepareToPlay. Altiverb is
+    // told, and is prepared for blocks of at least offlineBlockSize. Latency doesn't change.
+    static constexpr int offlineBlockSize = 4096;
+    bool offlineRendering = false;
     
-    // Audio buffers for VST2 processing
-    std::vector<float*> inputChannelPtrs;
-    std::vector<float*> outputChannelPtrs;
-    juce::AudioBuffer<float> internalInputBuffer;
-    juce::AudioBuffer<float> internalOutputBuffer;
+    // Pipelined mode: the FIFO's full blocks are processed on the engine thread
+    bool pipelinedModeEnabled = false;
+    EnginePipeline enginePipeline;
+    
+    // Timing of every processReplacing call and host block (audio thread writes)
+    DspLoadMetrics loadMetrics;
+    
+    // Skips the engine once inputs are silent and the reverb tail has died out
+    SilenceGate silenceGate;
+    
+    // Host bypass: crossfade to the dry signal delayed by our latency, then suspend the engine
+    enum class BypassState {
+        engaged,
+        fadingOut,   // Engine runs, output fades to dry
+        bypassed,    // Dry only, the timer suspends the engine
+        resuming,    // Host re-engaged, dry until the timer has resumed the engine
+        fadingIn     // Engine runs, output fades back from dry
+    };
+    std::atomic<BypassState> bypassState { BypassState::engaged };
+    BypassDelay bypassDelay;
+    static constexpr double bypassFadeSeconds = 0.01;
+    int bypassFadeLength = 480;
+    int bypassFadePosition = 0;              // Audio thread, except while resuming
+    bool engineSuspendedForBypass = false;   // Engine lock
+    std::atomic<int> pluginLatencySamples { 0 };  // AEffect::initialDelay
+    
+    // Processing path, chosen once in prepareToPlay
+    enum class ProcessingPath {
+        mapped,     // Copy host -> internal input, internal output -> host
+        zeroCopy,   // Copy host -> scratch input, plugin writes straight into host channels
+        inPlace     // Host channels passed as both inputs and outputs, no copies
+    };
+    ProcessingPath processingPath = ProcessingPath::mapped;
+    
+    // Surround format, from the host's buses in prepareToPlay
+    const SpeakerLayout* speakerLayout = &SpeakerLayout::getDefault();
+    ChannelKernels::CopyFn copyChannels = nullptr;  // Unrolled for the layout's channel count
+    
+    // User routing (engine lock), resolved for the layout in prepareToPlay
+    ChannelRouting channelRouting;
+    RoutingMatrix routingMatrix;
+    ChannelKernels::GainCopyFn gainCopy = nullptr;
+    bool routingPassThrough = true;
     
-    bool pluginLoaded = false;
     double currentSampleRate = 48000.0;
     int currentBlockSize = 512;
     
@@ -64,10 +228,77 @@ private:
     
     // VST2 path configuration (private helper)
     juce::String loadVST2PathFromRegistry();
+    bool loadFlagFromRegistry(const char* valueName);  // DWORD under HKCU\SOFTWARE\AltiverbWrapper, false if missing
+    
+    // Engine loading and setup
+    void startEngineLoad(const juce::String& path);
+    void onEngineLoaded();
+    void configureEngine();
+    void configureGroupEngines();
+    void onGroupEngineLoaded(int loadedGroup);
+    void captureEngineState(WrapperState& state);
+    void restoreEngineState(VST2Loader& engine, const WrapperState& state);
+    void mirrorStateToGroupEngines();
+    void requestGroupSync();
+    void syncGroupEnginesIfDirty();
+    void applyPendingState();
+    void runPendingRestore();
+    void syncParametersFromEngine();
+    void applyParameterChanges();
+    void forwardPluginEdits();
+    void resyncParametersFromEngine();
+    void timerCallback() override;
+    
+    // Altiverb's display text for a host parameter, empty until the engine is ready
+    juce::String getEngineParameterText(int index);
+    
+    // Block processing, shared by the float and double entry points
+    template <typename SampleType> void renderBlock(juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType> void renderBypassedBlock(juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType, typename RenderFn> void renderInPieces(juce::AudioBuffer<SampleType>& buffer, RenderFn&& render);
+    template <typename RenderFn> void renderConverted(juce::AudioBuffer<double>& buffer, RenderFn&& render);
+    
+    // Host transport for the engines' audioMasterGetTime: read once per host block,
+    // then published again for each later chunk so samplePos follows the chunks
+    void updateEngineTimeInfo();
+    void publishEngineTimeInfo(int startSample);
+    
+    // Bypass and latency
+    template <typename SampleType> void processEngineBlock(juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType> bool advanceBypassFade(juce::AudioBuffer<SampleType>& buffer, bool towardsDry);
+    void updateBypassedEngine();
+    void updateLatency();
+    
+    // State serialisation - takeSnapshot feeds the snapshot cache. Only collectState
+    // needs the engine lock; the container is written after it is released.
+    bool takeSnapshot(juce::MemoryBlock& destData);
+    void collectState(WrapperState& state);
+    
+    // Layout and processing path selection
+    const SpeakerLayout* chooseSpeakerLayout() const;
+    ProcessingPath chooseProcessingPath();
+    
+    // Scratch arena layout for the current processing path
+    void prepareScratchArena(int samplesPerBlock);
+    
+    // Timed call into the engine - processReplacing or processDoubleReplacing
+    template <typename SampleType> void processEngine(SampleType** inputs, SampleType** outputs, int numSamples);
+    
+    // One processReplacing per channel group, in parallel
+    void processEngineGroups(float** inputs, float** outputs, int numSamples);
+    
+    // Split mode or the constant-block FIFO (float only)
+    void processEngineChunks(juce::AudioBuffer<float>& buffer);
+    void processFifoBlock(float** inputs, float** outputs, int blockSize);  // Audio or engine thread
+    void processEngineChunks(juce::AudioBuffer<double>& buffer);
+    
+    // Process one chunk of at most maxChunkSize samples
+    void processChunk(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void processChunk(juce::AudioBuffer<double>& buffer, int startSample, int numSamples);
     
-    // Channel mapping for 5.1
-    void mapInputChannels(const juce::AudioBuffer<float>& buffer);
-    void mapOutputChannels(juce::AudioBuffer<float>& buffer);
+    // Routing matrix between host channels and the internal plugin-order buffers
+    void mapInputChannels(const float* const* hostChannels, int numHostChannels, int numSamples);
+    void mapOutputChannels(float* const* hostChannels, int numHostChannels, int numSamples);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AltiverbSurroundProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,365 @@
+#include "RealtimeAudit.h"
+
+#if ALTIVERB_RT_AUDIT && JUCE_LINUX
+ #include <cerrno>
+ #include <cxxabi.h>
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <poll.h>
+ #include <pthread.h>
+ #include <sys/select.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+namespace RealtimeAudit {
+
+const char* getViolationName(Violation kind) noexcept {
+    switch (kind) {
+        case Violation::allocation:   return "allocation";
+        case Violation::deallocation: return "deallocation";
+        case Violation::mutexLock:    return "mutex lock";
+        case Violation::blockingCall: return "blocking call";
+    }
+    return "unknown";
+}
+
+juce::int64 Summary::getTotal() const noexcept {
+    juce::int64 total = 0;
+    for (auto count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+juce::String Summary::toString() const {
+    juce::String text;
+    text << "Real-time audit: " << getTotal() << " violations";
+
+    for (int kind = 0; kind < numViolationKinds; ++kind) {
+        if (counts[kind] > 0) {
+            text << ", " << counts[kind] << " " << getViolationName((Violation)kind);
+        }
+    }
+    if (dropped > 0) {
+        text << " (" << dropped << " not logged)";
+    }
+    text << juce::newLine;
+
+    for (auto& site : callSites) {
+        text << "  " << site << juce::newLine;
+    }
+    return text;
+}
+
+#if ALTIVERB_RT_AUDIT
+
+namespace {
+
+constexpr int logCapacity = 4096;
+constexpr int maxFrames = 4;
+constexpr int skippedFrames = 2;  // recordViolation and the intercepted function
+
+struct Entry {
+    Violation kind;
+    const char* function;
+    void* frames[maxFrames];
+    int numFrames;
+    juce::Thread::ThreadID thread;
+    std::atomic<bool> complete;  // Set once the writer has filled in the rest
+};
+
+Entry violationLog[logCapacity];
+std::atomic<juce::uint32> numClaimed { 0 };
+std::atomic<juce::int64> violationCounts[numViolationKinds] {};
+std::atomic<juce::int64> numDropped { 0 };
+
+// Per thread: how deep in RealtimeSections it is, and whether it is recording
+// right now - the audit's own calls (backtrace may allocate) aren't violations
+thread_local int sectionDepth = 0;
+thread_local bool recording = false;
+
+juce::String describeFrame(void* address) {
+    #if JUCE_LINUX
+    Dl_info info;
+    if (dladdr(address, &info) != 0) {
+        if (info.dli_sname != nullptr) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            juce::String name = (status == 0 && demangled != nullptr) ? demangled : info.dli_sname;
+            std::free(demangled);
+
+            // Argument lists make templated names unreadable
+            return name.upToFirstOccurrenceOf("(", false, false) + "+0x"
+                 + juce::String::toHexString((juce::pointer_sized_int)((char*)address - (char*)info.dli_saddr));
+        }
+        if (info.dli_fname != nullptr) {
+            return juce::File(info.dli_fname).getFileName() + "+0x"
+                 + juce::String::toHexString((juce::pointer_sized_int)((char*)address - (char*)info.dli_fbase));
+        }
+    }
+    #endif
+    return "0x" + juce::String::toHexString((juce::pointer_sized_int)address);
+}
+
+} // namespace
+
+RealtimeSection::RealtimeSection() noexcept {
+    ++sectionDepth;
+}
+
+RealtimeSection::~RealtimeSection() {
+    --sectionDepth;
+}
+
+#if JUCE_LINUX
+__attribute__((noinline))  // The frames skipped below are this function and its caller
+#endif
+void recordViolation(Violation kind, const char* function) noexcept {
+    if (sectionDepth == 0 || recording) {
+        return;
+    }
+    recording = true;
+
+    violationCounts[(int)kind].fetch_add(1, std::memory_order_relaxed);
+    const auto index = numClaimed.fetch_add(1, std::memory_order_relaxed);
+
+    if (index < (juce::uint32)logCapacity) {
+        auto& entry = violationLog[index];
+        entry.kind = kind;
+        entry.function = function;
+        entry.thread = juce::Thread::getCurrentThreadId();
+        entry.numFrames = 0;
+
+        #if JUCE_LINUX
+        void* frames[maxFrames + skippedFrames];
+        const int numFrames = backtrace(frames, maxFrames + skippedFrames);
+
+        for (int i = skippedFrames; i < numFrames; ++i) {
+            entry.frames[entry.numFrames++] = frames[i];
+        }
+        #endif
+
+        entry.complete.store(true, std::memory_order_release);
+    } else {
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    recording = false;
+}
+
+void beginSession() {
+    #if JUCE_LINUX
+    // The first backtrace loads the unwinder - not on an audio thread
+    void* frame[1];
+    backtrace(frame, 1);
+    #endif
+
+    const auto numEntries = juce::jmin((juce::uint32)logCapacity, numClaimed.load());
+    for (juce::uint32 i = 0; i < numEntries; ++i) {
+        violationLog[i].complete.store(false);
+    }
+
+    for (auto& count : violationCounts) {
+        count.store(0);
+    }
+    numDropped.store(0);
+    numClaimed.store(0);
+}
+
+Summary getSummary(int maxCallSites) {
+    Summary summary;
+    for (int kind = 0; kind < numViolationKinds; ++kind) {
+        summary.counts[kind] = violationCounts[kind].load();
+    }
+    summary.dropped = numDropped.load();
+
+    // Group the log by kind, function and stack
+    struct CallSite {
+        const Entry* first;
+        juce::int64 count;
+    };
+    std::vector<CallSite> sites;
+
+    auto sameSite = [](const Entry& a, const Entry& b) {
+        return a.kind == b.kind && a.function == b.function && a.numFrames == b.numFrames
+            && std::equal(a.frames, a.frames + a.numFrames, b.frames);
+    };
+
+    const auto numEntries = juce::jmin((juce::uint32)logCapacity, numClaimed.load(std::memory_order_acquire));
+    for (juce::uint32 i = 0; i < numEntries; ++i) {
+        const auto& entry = violationLog[i];
+        if (!entry.complete.load(std::memory_order_acquire)) {
+            continue;  // Still being written
+        }
+
+        auto site = std::find_if(sites.begin(), sites.end(), [&](const CallSite& s) { return sameSite(*s.first, entry); });
+        if (site == sites.end()) {
+            sites.push_back({ &entry, 1 });
+        } else {
+            ++site->count;
+        }
+    }
+
+    std::stable_sort(sites.begin(), sites.end(), [](const CallSite& a, const CallSite& b) { return a.count > b.count; });
+
+    for (int i = 0; i < juce::jmin(maxCallSites, (int)sites.size()); ++i) {
+        const auto& entry = *sites[(size_t)i].first;
+
+        juce::String line;
+        line << sites[(size_t)i].count << " x " << getViolationName(entry.kind) << " (" << entry.function << ")";
+        for (int frame = 0; frame < entry.numFrames; ++frame) {
+            line << (frame == 0 ? " at " : " <- ") << describeFrame(entry.frames[frame]);
+        }
+        line << " [thread 0x" << juce::String::toHexString((juce::pointer_sized_int)entry.thread) << "]";
+
+        summary.callSites.add(line);
+    }
+    return summary;
+}
+
+#else
+
+void recordViolation(Violation, const char*) noexcept {}
+void beginSession() {}
+Summary getSummary(int) { return {}; }
+
+#endif
+
+} // namespace RealtimeAudit
+
+//==============================================================================
+// Linux: the C library's entry points, interposed. Memory goes straight to
+// glibc's allocator; everything else to the next definition in link order.
+
+#if ALTIVERB_RT_AUDIT && JUCE_LINUX
+
+using RealtimeAudit::Violation;
+using RealtimeAudit::recordViolation;
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+enum NextFunction { nextMutexLock, nextNanosleep, nextClockNanosleep, nextUsleep, nextPoll, nextSelect,
+                    nextRead, nextWrite, numNextFunctions };
+
+const char* const nextFunctionNames[numNextFunctions] = {
+    "pthread_mutex_lock", "nanosleep", "clock_nanosleep", "usleep", "poll", "select", "read", "write"
+};
+
+std::atomic<void*> nextFunctions[numNextFunctions] {};
+
+template <typename Fn>
+Fn getNext(NextFunction which) noexcept {
+    void* fn = nextFunctions[which].load(std::memory_order_relaxed);
+    if (fn == nullptr) {
+        fn = dlsym(RTLD_NEXT, nextFunctionNames[which]);
+        nextFunctions[which].store(fn, std::memory_order_relaxed);
+    }
+    return reinterpret_cast<Fn>(fn);
+}
+
+// Resolved before main, so an audio thread never ends up in dlsym
+struct ResolveAtStartup {
+    ResolveAtStartup() {
+        for (int i = 0; i < numNextFunctions; ++i) {
+            getNext<void*>((NextFunction)i);
+        }
+    }
+} resolveAtStartup;
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) noexcept {
+    recordViolation(Violation::allocation, "malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    recordViolation(Violation::allocation, "calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+    recordViolation(Violation::allocation, "realloc");
+    return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) noexcept {
+    recordViolation(Violation::allocation, "posix_memalign");
+
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* ptr = __libc_memalign(alignment, size);
+    if (ptr == nullptr) {
+        return ENOMEM;
+    }
+    *result = ptr;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+    recordViolation(Violation::allocation, "aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+void free(void* ptr) noexcept {
+    if (ptr != nullptr) {
+        recordViolation(Violation::deallocation, "free");
+    }
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+    recordViolation(Violation::mutexLock, "pthread_mutex_lock");
+    return getNext<int (*)(pthread_mutex_t*)>(nextMutexLock)(mutex);
+}
+
+int nanosleep(const struct timespec* duration, struct timespec* remaining) {
+    recordViolation(Violation::blockingCall, "nanosleep");
+    return getNext<int (*)(const struct timespec*, struct timespec*)>(nextNanosleep)(duration, remaining);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const struct timespec* duration, struct timespec* remaining) {
+    recordViolation(Violation::blockingCall, "clock_nanosleep");
+    return getNext<int (*)(clockid_t, int, const struct timespec*, struct timespec*)>(nextClockNanosleep)(clock, flags, duration, remaining);
+}
+
+int usleep(useconds_t microseconds) {
+    recordViolation(Violation::blockingCall, "usleep");
+    return getNext<int (*)(useconds_t)>(nextUsleep)(microseconds);
+}
+
+int poll(struct pollfd* fds, nfds_t numFds, int timeout) {
+    recordViolation(Violation::blockingCall, "poll");
+    return getNext<int (*)(struct pollfd*, nfds_t, int)>(nextPoll)(fds, numFds, timeout);
+}
+
+int select(int numFds, fd_set* readFds, fd_set* writeFds, fd_set* exceptFds, struct timeval* timeout) {
+    recordViolation(Violation::blockingCall, "select");
+    return getNext<int (*)(int, fd_set*, fd_set*, fd_set*, struct timeval*)>(nextSelect)(numFds, readFds, writeFds, exceptFds, timeout);
+}
+
+ssize_t read(int fd, void* buffer, size_t size) {
+    recordViolation(Violation::blockingCall, "read");
+    return getNext<ssize_t (*)(int, void*, size_t)>(nextRead)(fd, buffer, size);
+}
+
+ssize_t write(int fd, const void* buffer, size_t size) {
+    recordViolation(Violation::blockingCall, "write");
+    return getNext<ssize_t (*)(int, const void*, size_t)>(nextWrite)(fd, buffer, size);
+}
+
+} // extern "C"
+
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+// Real-time safety audit, compiled in with ALTIVERB_RT_AUDIT=1.
+//
+// Code that runs on an audio thread marks itself with a RealtimeSection.
+// While a thread is inside one, heap allocations, mutex locks and blocking
+// system calls are recorded as violations - the wrapper's own and those of
+// the hosted plugin alike. On Linux the C library entry points are
+// interposed, which takes effect when the audit is linked into the
+// executable (AltiverbBench's Audit configuration) or preloaded; other
+// builds keep the sections but intercept nothing.
+//
+// Recording never blocks: a violation claims a slot of a fixed log with one
+// atomic increment, and a full log only counts what it drops. The summary
+// groups the log by call site and is built off the audio thread.
+#ifndef ALTIVERB_RT_AUDIT
+ #define ALTIVERB_RT_AUDIT 0
+#endif
+
+namespace RealtimeAudit {
+
+constexpr bool enabled = ALTIVERB_RT_AUDIT != 0;
+
+enum class Violation { allocation, deallocation, mutexLock, blockingCall };
+constexpr int numViolationKinds = 4;
+
+const char* getViolationName(Violation kind) noexcept;
+
+// Marks the calling thread as real-time for its lifetime. Sections nest.
+class RealtimeSection {
+public:
+#if ALTIVERB_RT_AUDIT
+    RealtimeSection() noexcept;
+    ~RealtimeSection();
+#else
+    RealtimeSection() noexcept {}
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE(RealtimeSection)
+};
+
+// Audio thread: records a violation at the caller of the intercepted function
+void recordViolation(Violation kind, const char* function) noexcept;
+
+struct Summary {
+    juce::int64 counts[numViolationKinds] {};
+    juce::int64 dropped = 0;             // Violations the full log couldn't keep
+    juce::StringArray callSites;         // Most frequent first
+
+    juce::int64 getTotal() const noexcept;
+    juce::String toString() const;
+};
+
+// While no audio thread is running: clears the log for a new session
+void beginSession();
+
+// Violations since beginSession(), grouped by call site
+Summary getSummary(int maxCallSites = 20);
+
+} // namespace RealtimeAudit
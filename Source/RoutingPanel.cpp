@@ -0,0 +1,98 @@
+#include "RoutingPanel.h"
+
+namespace {
+constexpr int rowHeight = 24;
+constexpr int headerHeight = 56;
+constexpr int panelWidth = 380;
+}
+
+RoutingPanel::RoutingPanel(AltiverbSurroundProcessor& p)
+    : audioProcessor(p)
+{
+    const auto routing = audioProcessor.getChannelRouting();
+    const auto& layout = audioProcessor.getSpeakerLayout();
+
+    orderBox.addItem("Standard order (L R C LFE ...)", 1);
+    orderBox.addItem("Film order (L C R ... LFE)", 2);
+    orderBox.setSelectedId(routing.order == ChannelRouting::Order::film ? 2 : 1, juce::dontSendNotification);
+    orderBox.onChange = [this] { applyRouting(); };
+    addAndMakeVisible(orderBox);
+
+    inputHeader.setText("Input trim", juce::dontSendNotification);
+    outputHeader.setText("Output trim", juce::dontSendNotification);
+    addAndMakeVisible(inputHeader);
+    addAndMakeVisible(outputHeader);
+
+    // One row per plugin channel of the layout the host prepared
+    for (int ch = 0; ch < layout.numChannels; ++ch) {
+        auto* row = rows.add(new ChannelRow());
+        const auto& channel = routing.channels[ch];
+
+        row->name.setText(layout.speakers[ch].name, juce::dontSendNotification);
+        addAndMakeVisible(row->name);
+
+        setUpTrimSlider(row->inputTrim, channel.inputTrimDb);
+        setUpTrimSlider(row->outputTrim, channel.outputTrimDb);
+
+        for (auto* invert : { &row->inputInvert, &row->outputInvert }) {
+            invert->setButtonText("Inv");
+            invert->onClick = [this] { applyRouting(); };
+            addAndMakeVisible(*invert);
+        }
+        row->inputInvert.setToggleState(channel.inputInverted, juce::dontSendNotification);
+        row->outputInvert.setToggleState(channel.outputInverted, juce::dontSendNotification);
+    }
+
+    setSize(panelWidth, headerHeight + layout.numChannels * rowHeight + 8);
+}
+
+void RoutingPanel::setUpTrimSlider(juce::Slider& slider, float trimDb) {
+    slider.setSliderStyle(juce::Slider::LinearHorizontal);
+    slider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 52, 20);
+    slider.setRange(ChannelRouting::minTrimDb, ChannelRouting::maxTrimDb, 0.5);
+    slider.setTextValueSuffix(" dB");
+    slider.setDoubleClickReturnValue(true, 0.0);
+    slider.setChangeNotificationOnlyOnRelease(true);
+    slider.setValue(trimDb, juce::dontSendNotification);
+    slider.onValueChange = [this] { applyRouting(); };
+    addAndMakeVisible(slider);
+}
+
+void RoutingPanel::resized() {
+    auto bounds = getLocalBounds().reduced(4);
+
+    orderBox.setBounds(bounds.removeFromTop(24));
+    bounds.removeFromTop(4);
+
+    auto header = bounds.removeFromTop(20);
+    header.removeFromLeft(40);
+    inputHeader.setBounds(header.removeFromLeft(header.getWidth() / 2));
+    outputHeader.setBounds(header);
+
+    for (auto* row : rows) {
+        auto area = bounds.removeFromTop(rowHeight);
+        row->name.setBounds(area.removeFromLeft(40));
+
+        auto inputArea = area.removeFromLeft(area.getWidth() / 2);
+        row->inputInvert.setBounds(inputArea.removeFromRight(44));
+        row->inputTrim.setBounds(inputArea);
+        row->outputInvert.setBounds(area.removeFromRight(44));
+        row->outputTrim.setBounds(area);
+    }
+}
+
+void RoutingPanel::applyRouting() {
+    // Channels beyond this layout keep their settings
+    auto routing = audioProcessor.getChannelRouting();
+    routing.order = orderBox.getSelectedId() == 2 ? ChannelRouting::Order::film : ChannelRouting::Order::standard;
+
+    for (int ch = 0; ch < rows.size(); ++ch) {
+        auto& channel = routing.channels[ch];
+        channel.inputTrimDb = (float)rows[ch]->inputTrim.getValue();
+        channel.inputInverted = rows[ch]->inputInvert.getToggleState();
+        channel.outputTrimDb = (float)rows[ch]->outputTrim.getValue();
+        channel.outputInverted = rows[ch]->outputInvert.getToggleState();
+    }
+
+    audioProcessor.setChannelRouting(routing);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// Channel order, trim and polarity for the current layout, shown in a
+// call-out from the main editor. Changes go to the processor straight away;
+// trims only once the slider is let go, as each change re-prepares.
+class RoutingPanel : public juce::Component {
+public:
+    explicit RoutingPanel(AltiverbSurroundProcessor& processor);
+
+    void resized() override;
+
+private:
+    struct ChannelRow {
+        juce::Label name;
+        juce::Slider inputTrim;
+        juce::ToggleButton inputInvert;
+        juce::Slider outputTrim;
+        juce::ToggleButton outputInvert;
+    };
+
+    AltiverbSurroundProcessor& audioProcessor;
+    juce::ComboBox orderBox;
+    juce::Label inputHeader;
+    juce::Label outputHeader;
+    juce::OwnedArray<ChannelRow> rows;
+
+    void setUpTrimSlider(juce::Slider& slider, float trimDb);
+    void applyRouting();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RoutingPanel)
+};
@@ -0,0 +1,40 @@
+#include "ScratchArena.h"
+
+static size_t alignToCacheLine(size_t numBytes) {
+    return (numBytes + ScratchArena::cacheLineSize - 1) & ~(ScratchArena::cacheLineSize - 1);
+}
+
+void ScratchArena::beginLayout() {
+    layoutSize = 0;
+}
+
+size_t ScratchArena::reserve(size_t numBytes) {
+    size_t offset = layoutSize;
+    layoutSize += alignToCacheLine(numBytes);
+    return offset;
+}
+
+void ScratchArena::allocate() {
+    // Reuse the existing block if the new layout fits
+    if (layoutSize > allocatedSize || base == nullptr) {
+        storage.calloc(layoutSize + cacheLineSize);
+        allocatedSize = layoutSize;
+    }
+    
+    auto address = reinterpret_cast<uintptr_t>(storage.get());
+    base = reinterpret_cast<char*>(alignToCacheLine(address));
+    
+    std::memset(base, 0, layoutSize);
+}
+
+void ScratchArena::release() {
+    storage.free();
+    base = nullptr;
+    layoutSize = 0;
+    allocatedSize = 0;
+}
+
+int ScratchArena::alignSamples(int numSamples) noexcept {
+    const int samplesPerLine = (int)(cacheLineSize / sizeof(float));
+    return ((juce::jmax(1, numSamples) + samplesPerLine - 1) / samplesPerLine) * samplesPerLine;
+}
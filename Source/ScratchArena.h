@@ -0,0 +1,39 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Single cache-line aligned allocation holding all per-block scratch memory.
+// Regions are reserved while preparing (message thread), then the arena is
+// allocated once so the audio thread never touches the heap.
+class ScratchArena {
+public:
+    static constexpr size_t cacheLineSize = 64;
+    
+    ScratchArena() = default;
+    
+    // Layout - call beginLayout(), reserve() every region, then allocate()
+    void beginLayout();
+    size_t reserve(size_t numBytes);  // Returns the region's offset
+    
+    template <typename T>
+    size_t reserveArray(size_t count) { return reserve(count * sizeof(T)); }
+    
+    void allocate();
+    void release();
+    
+    // Region access (valid after allocate)
+    template <typename T>
+    T* getArray(size_t offset) const noexcept { return reinterpret_cast<T*>(base + offset); }
+    
+    size_t getSizeInBytes() const noexcept { return layoutSize; }
+    
+    // Round a sample count up so each channel starts on a cache line
+    static int alignSamples(int numSamples) noexcept;
+    
+private:
+    juce::HeapBlock<char> storage;
+    char* base = nullptr;
+    size_t layoutSize = 0;
+    size_t allocatedSize = 0;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScratchArena)
+};
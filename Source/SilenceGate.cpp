@@ -0,0 +1,95 @@
+#include "SilenceGate.h"
+
+void SilenceGate::prepare(double sampleRate) {
+    currentSampleRate = sampleRate;
+    holdSamples = (juce::int64)(sampleRate * outputHoldSeconds);
+
+    // Start awake - the engine's buffers may still hold audio from before
+    state = State::active;
+    silentInputSamples = 0;
+    silentOutputSamples = 0;
+    asleep.store(false, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+bool SilenceGate::shouldProcess(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept {
+    if (!isSilent(buffer, numChannels)) {
+        // Signal is back - the engine runs on this very block
+        state = State::active;
+        silentInputSamples = 0;
+        silentOutputSamples = 0;
+        asleep.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (state == State::asleep) {
+        return false;
+    }
+
+    state = State::tail;
+    return true;
+}
+
+template <typename SampleType>
+bool SilenceGate::blockProcessed(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept {
+    if (state != State::tail) {
+        return false;
+    }
+
+    const int numSamples = buffer.getNumSamples();
+    silentInputSamples += numSamples;
+    silentOutputSamples = isSilent(buffer, numChannels) ? silentOutputSamples + numSamples : 0;
+
+    // The last input only reaches the output after the latency - a burst shorter than
+    // it leaves the output silent until then, without its tail having started
+    const juce::int64 latency = latencySamples.load(std::memory_order_relaxed);
+    const int pluginTail = pluginTailSamples.load(std::memory_order_relaxed);
+    const bool tailOver = silentOutputSamples >= holdSamples + latency
+                       && silentInputSamples >= (juce::int64)pluginTail + latency;
+
+    if (!tailOver) {
+        return false;
+    }
+
+    // How long the reverb rang on after the input stopped
+    const double decaySeconds = (double)juce::jmax((juce::int64)0, silentInputSamples - silentOutputSamples - latency) / currentSampleRate;
+    if (decaySeconds > measuredTailSeconds.load(std::memory_order_relaxed)) {
+        measuredTailSeconds.store(decaySeconds, std::memory_order_relaxed);
+    }
+
+    state = State::asleep;
+    asleep.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+double SilenceGate::getTailSeconds() const noexcept {
+    const int pluginTail = pluginTailSamples.load(std::memory_order_relaxed);
+    if (pluginTail > 1) {
+        return pluginTail / currentSampleRate;
+    }
+
+    const double measured = measuredTailSeconds.load(std::memory_order_relaxed);
+    return measured > 0.0 ? measured : defaultTailSeconds;
+}
+
+template <typename SampleType>
+bool SilenceGate::isSilent(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept {
+    const int numSamples = buffer.getNumSamples();
+
+    for (int ch = 0; ch < juce::jmin(numChannels, buffer.getNumChannels()); ++ch) {
+        // Vectorised min/max - much cheaper than the engine it may save
+        auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(ch), numSamples);
+        if (range.getStart() <= -silenceThreshold || range.getEnd() >= silenceThreshold) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template bool SilenceGate::shouldProcess(const juce::AudioBuffer<float>&, int) noexcept;
+template bool SilenceGate::shouldProcess(const juce::AudioBuffer<double>&, int) noexcept;
+template bool SilenceGate::blockProcessed(const juce::AudioBuffer<float>&, int) noexcept;
+template bool SilenceGate::blockProcessed(const juce::AudioBuffer<double>&, int) noexcept;
+template bool SilenceGate::isSilent(const juce::AudioBuffer<float>&, int) noexcept;
+template bool SilenceGate::isSilent(const juce::AudioBuffer<double>&, int) noexcept;
@@ -0,0 +1,67 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+// Puts the engine to sleep while there is nothing to hear.
+//
+// Once all inputs go digitally silent the engine keeps running until its
+// reverb tail has died away: the outputs have stayed silent for a short
+// hold time, and at least the tail length the plugin reports has passed -
+// both counted from when the wrapper's latency has let the last input out.
+// After that the processor skips the engine and writes zeros until any
+// input sample rises above the threshold again. The engine's own buffers
+// have decayed to silence by then, so picking up where it left off is
+// seamless.
+//
+// The time from input silence to output silence is measured on every
+// decay and gives the host a real tail length when the plugin has none.
+class SilenceGate {
+public:
+    static constexpr float silenceThreshold = 1.0e-6f;     // About -120 dBFS
+    static constexpr double outputHoldSeconds = 0.1;
+    static constexpr double defaultTailSeconds = 10.0;     // Until a decay has been measured
+
+    SilenceGate() = default;
+
+    void prepare(double sampleRate);
+
+    // Tail the plugin reports via effGetTailSize (0 = unknown, 1 = none)
+    void setPluginTailSamples(int numSamples) noexcept { pluginTailSamples.store(numSamples, std::memory_order_relaxed); }
+
+    // Latency the wrapper reports - the FIFO block plus the plugin's initialDelay
+    void setLatencySamples(int numSamples) noexcept { latencySamples.store(numSamples, std::memory_order_relaxed); }
+
+    // Audio thread: checks the block's input - false means skip the engine and output silence
+    template <typename SampleType>
+    bool shouldProcess(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept;
+
+    // Audio thread: checks the output of a block the engine processed. True when
+    // this block put the engine to sleep - the owner drops whatever it still buffers.
+    template <typename SampleType>
+    bool blockProcessed(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept;
+
+    bool isAsleep() const noexcept { return asleep.load(std::memory_order_relaxed); }
+
+    // Any thread: the plugin's tail if it has one, otherwise the longest measured decay
+    double getTailSeconds() const noexcept;
+
+    // Float and double buffers
+    template <typename SampleType>
+    static bool isSilent(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept;
+
+private:
+    enum class State { active, tail, asleep };
+
+    State state = State::active;
+    double currentSampleRate = 48000.0;
+    juce::int64 holdSamples = 4800;
+    juce::int64 silentInputSamples = 0;
+    juce::int64 silentOutputSamples = 0;
+
+    std::atomic<int> pluginTailSamples { 0 };
+    std::atomic<int> latencySamples { 0 };
+    std::atomic<bool> asleep { false };
+    std::atomic<double> measuredTailSeconds { 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SilenceGate)
+};
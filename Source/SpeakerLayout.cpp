@@ -0,0 +1,115 @@
+#include "SpeakerLayout.h"
+
+namespace {
+
+// Speaker types as negotiated since 1.0
+const SpeakerLayout::Speaker speakers51[] = {
+    { "L",   -30.0f,  0.0f, 0, 0, 0 },
+    { "R",    30.0f,  0.0f, 1, 1, 2 },
+    { "C",     0.0f,  0.0f, 2, 2, 1 },
+    { "LFE",   0.0f,  0.0f, 3, 3, 5 },
+    { "Ls", -110.0f,  0.0f, 4, 4, 3 },
+    { "Rs",  110.0f,  0.0f, 5, 5, 4 }
+};
+
+// VST2 7.1 Music: rears before sides, JUCE has the sides first.
+// Film order is L C R, sides, rears, LFE, then any heights.
+const SpeakerLayout::Speaker speakers71[] = {
+    { "L",   -30.0f,  0.0f, kSpeakerL,   0, 0 },
+    { "R",    30.0f,  0.0f, kSpeakerR,   1, 2 },
+    { "C",     0.0f,  0.0f, kSpeakerC,   2, 1 },
+    { "LFE",   0.0f,  0.0f, kSpeakerLfe, 3, 7 },
+    { "Ls", -135.0f,  0.0f, kSpeakerLs,  6, 5 },
+    { "Rs",  135.0f,  0.0f, kSpeakerRs,  7, 6 },
+    { "Sl",  -90.0f,  0.0f, kSpeakerSl,  4, 3 },
+    { "Sr",   90.0f,  0.0f, kSpeakerSr,  5, 4 }
+};
+
+// 7.1 Music plus four heights - JUCE puts the heights before the rears
+const SpeakerLayout::Speaker speakers714[] = {
+    { "L",    -30.0f,  0.0f, kSpeakerL,   0, 0 },
+    { "R",     30.0f,  0.0f, kSpeakerR,   1, 2 },
+    { "C",      0.0f,  0.0f, kSpeakerC,   2, 1 },
+    { "LFE",    0.0f,  0.0f, kSpeakerLfe, 3, 7 },
+    { "Ls",  -135.0f,  0.0f, kSpeakerLs,  10, 5 },
+    { "Rs",   135.0f,  0.0f, kSpeakerRs,  11, 6 },
+    { "Sl",   -90.0f,  0.0f, kSpeakerSl,  4, 3 },
+    { "Sr",    90.0f,  0.0f, kSpeakerSr,  5, 4 },
+    { "Tfl",  -45.0f, 45.0f, kSpeakerTfl, 6, 8 },
+    { "Tfr",   45.0f, 45.0f, kSpeakerTfr, 7, 9 },
+    { "Trl", -135.0f, 45.0f, kSpeakerTrl, 8, 10 },
+    { "Trr",  135.0f, 45.0f, kSpeakerTrr, 9, 11 }
+};
+
+// Split engines: front pair, centre and LFE, surrounds - or the bed and the heights
+const SpeakerLayout::Group groups51[] = {
+    { "L/R",   0, 2, kSpeakerArrStereo },
+    { "C/LFE", 2, 2, kSpeakerArrStereoCLfe },
+    { "Ls/Rs", 4, 2, kSpeakerArrStereoSurround }
+};
+
+const SpeakerLayout::Group groups71[] = {
+    { "L/R",        0, 2, kSpeakerArrStereo },
+    { "C/LFE",      2, 2, kSpeakerArrStereoCLfe },
+    { "Surrounds",  4, 4, kSpeakerArrUserDefined }
+};
+
+const SpeakerLayout::Group groups714[] = {
+    { "7.1 Bed", 0, 8, kSpeakerArr71Music },
+    { "Heights", 8, 4, kSpeakerArrUserDefined }
+};
+
+const SpeakerLayout layouts[] = {
+    { "5.1",   6,  kSpeakerArr51,          speakers51,  &juce::AudioChannelSet::create5point1,      groups51,  3 },
+    { "7.1",   8,  kSpeakerArr71Music,     speakers71,  &juce::AudioChannelSet::create7point1,      groups71,  3 },
+    { "7.1.4", 12, kSpeakerArrUserDefined, speakers714, &juce::AudioChannelSet::create7point1point4, groups714, 2 }
+};
+
+} // namespace
+
+bool SpeakerLayout::isHostOrder() const noexcept {
+    for (int ch = 0; ch < numChannels; ++ch) {
+        if (speakers[ch].hostChannel != ch) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SpeakerLayout::fillArrangement(VstSpeakerArrangement& arrangement) const {
+    arrangement.type = arrangementType;
+    arrangement.numChannels = numChannels;
+
+    for (int i = 0; i < numChannels; ++i) {
+        VstSpeakerProperties& properties = arrangement.speakers[i];
+        properties.azimuth = speakers[i].azimuth;
+        properties.elevation = speakers[i].elevation;
+        properties.radius = 1.0f;
+        properties.reserved = 0.0f;
+        strncpy(properties.name, speakers[i].name, 63);
+        properties.name[63] = 0;
+        properties.type = speakers[i].type;
+    }
+}
+
+SpeakerLayout SpeakerLayout::getGroupLayout(int group) const noexcept {
+    jassert(juce::isPositiveAndBelow(group, numGroups));
+    const auto& g = groups[group];
+
+    return { g.name, g.numChannels, g.arrangementType, speakers + g.firstChannel, nullptr, groups + group, 1 };
+}
+
+const SpeakerLayout& SpeakerLayout::getDefault() {
+    return layouts[0];
+}
+
+const SpeakerLayout* SpeakerLayout::find(const juce::AudioChannelSet& channelSet) {
+    for (const auto& layout : layouts) {
+        if (layout.createChannelSet() == channelSet) {
+            return &layout;
+        }
+    }
+
+    return nullptr;
+}
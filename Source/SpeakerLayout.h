@@ -0,0 +1,55 @@
+#pragma once
+#include <JuceHeader.h>
+#include "VST2Types.h"
+
+// A surround format the wrapper can run Altiverb in: 5.1, 7.1 or 7.1.4.
+//
+// Each layout knows its JUCE channel set, the VST2 arrangement negotiated with
+// the plugin, and where each of the plugin's channels sits in the host buffer.
+// JUCE and VST2 order the side and rear pairs differently from 7.1 up, so the
+// processor routes through hostChannel instead of assuming the orders match.
+//
+// A layout can also be split into channel groups, each run by its own
+// Altiverb instance. Groups are contiguous in plugin order.
+struct SpeakerLayout {
+    static constexpr int maxChannels = 12;  // 7.1.4
+    static constexpr int maxGroups = 3;
+
+    struct Speaker {
+        const char* name;
+        float azimuth;
+        float elevation;
+        VstInt32 type;
+        int hostChannel;  // Index of this plugin channel in the host buffer
+        int filmChannel;  // Its index when the material is in film order
+    };
+
+    struct Group {
+        const char* name;
+        int firstChannel;  // Plugin order
+        int numChannels;
+        VstInt32 arrangementType;
+    };
+
+    const char* name;
+    int numChannels;
+    VstInt32 arrangementType;
+    const Speaker* speakers;  // Plugin order
+    juce::AudioChannelSet (*createChannelSet)();  // Null for a group
+    const Group* groups;
+    int numGroups;
+
+    // True when plugin and host channel orders are the same
+    bool isHostOrder() const noexcept;
+
+    void fillArrangement(VstSpeakerArrangement& arrangement) const;
+
+    // The speakers of one group as a layout of their own, for the engine that runs them
+    SpeakerLayout getGroupLayout(int group) const noexcept;
+
+    // 5.1 - the layout pooled engines are negotiated to
+    static const SpeakerLayout& getDefault();
+
+    // Null if the channel set isn't one of the supported layouts
+    static const SpeakerLayout* find(const juce::AudioChannelSet& channelSet);
+};
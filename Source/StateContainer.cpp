@@ -0,0 +1,268 @@
+#include "StateContainer.h"
+
+namespace StateContainer {
+
+namespace {
+
+constexpr juce::uint32 sectionWrapper = 0x50415257;     // 'WRAP'
+constexpr juce::uint32 sectionChunk = 0x4B4E4843;       // 'CHNK'
+constexpr juce::uint32 sectionParameters = 0x4D524150;  // 'PARM'
+constexpr juce::uint32 sectionRouting = 0x54554F52;     // 'ROUT'
+
+constexpr juce::uint16 flagCompressed = 1 << 0;
+
+constexpr juce::uint8 wrapperConstantBlockMode = 1 << 0;
+constexpr juce::uint8 wrapperEngineLoaded = 1 << 1;
+constexpr juce::uint8 wrapperSplitEngines = 1 << 2;
+constexpr juce::uint8 wrapperPipelined = 1 << 3;
+
+constexpr juce::uint8 routingInputInverted = 1 << 0;
+constexpr juce::uint8 routingOutputInverted = 1 << 1;
+
+constexpr int headerSize = 16;
+
+void writeSection(juce::MemoryOutputStream& out, juce::uint32 id, const void* data, size_t size) {
+    out.writeInt((int)id);
+    out.writeInt((int)size);
+    out.write(data, size);
+}
+
+void writePayload(const WrapperState& state, juce::MemoryOutputStream& out) {
+    // Wrapper settings
+    {
+        juce::MemoryOutputStream section;
+        juce::uint8 flags = 0;
+        if (state.constantBlockMode) flags |= wrapperConstantBlockMode;
+        if (state.engineLoaded) flags |= wrapperEngineLoaded;
+        if (state.splitEngines) flags |= wrapperSplitEngines;
+        if (state.pipelined) flags |= wrapperPipelined;
+
+        const size_t pathBytes = state.vst2Path.getNumBytesAsUTF8();
+        section.writeByte((char)flags);
+        section.writeInt((int)pathBytes);
+        section.write(state.vst2Path.toRawUTF8(), pathBytes);
+        writeSection(out, sectionWrapper, section.getData(), section.getDataSize());
+    }
+
+    // Chunk goes in untouched
+    if (state.chunk.getSize() > 0) {
+        writeSection(out, sectionChunk, state.chunk.getData(), state.chunk.getSize());
+    }
+
+    // Parameters as one packed float array
+    if (state.hasParameters) {
+        juce::MemoryOutputStream section;
+        section.writeInt(state.currentProgram);
+        section.writeInt(state.parameters.size());
+        for (float value : state.parameters) {
+            section.writeFloat(value);
+        }
+        writeSection(out, sectionParameters, section.getData(), section.getDataSize());
+    }
+
+    // Channel routing, if there is any
+    if (!state.routing.isPassThrough()) {
+        juce::MemoryOutputStream section;
+        section.writeByte((char)state.routing.order);
+        section.writeByte((char)SpeakerLayout::maxChannels);
+        for (const auto& channel : state.routing.channels) {
+            juce::uint8 flags = 0;
+            if (channel.inputInverted) flags |= routingInputInverted;
+            if (channel.outputInverted) flags |= routingOutputInverted;
+
+            section.writeFloat(channel.inputTrimDb);
+            section.writeFloat(channel.outputTrimDb);
+            section.writeByte((char)flags);
+        }
+        writeSection(out, sectionRouting, section.getData(), section.getDataSize());
+    }
+}
+
+bool readPayload(const void* data, size_t size, WrapperState& state) {
+    juce::MemoryInputStream in(data, size, false);
+
+    while (in.getNumBytesRemaining() >= 8) {
+        const auto id = (juce::uint32)in.readInt();
+        const auto sectionSize = (juce::uint32)in.readInt();
+
+        if ((juce::int64)sectionSize > in.getNumBytesRemaining()) {
+            return false;
+        }
+
+        const char* sectionData = static_cast<const char*>(data) + in.getPosition();
+        juce::MemoryInputStream section(sectionData, sectionSize, false);
+
+        switch (id) {
+            case sectionWrapper: {
+                const auto flags = (juce::uint8)section.readByte();
+                const auto pathBytes = (juce::uint32)section.readInt();
+                if ((juce::int64)pathBytes > section.getNumBytesRemaining()) {
+                    return false;
+                }
+                state.constantBlockMode = (flags & wrapperConstantBlockMode) != 0;
+                state.engineLoaded = (flags & wrapperEngineLoaded) != 0;
+                state.splitEngines = (flags & wrapperSplitEngines) != 0;
+                state.pipelined = (flags & wrapperPipelined) != 0;
+                state.vst2Path = juce::String::fromUTF8(sectionData + section.getPosition(), (int)pathBytes);
+                break;
+            }
+
+            case sectionChunk:
+                state.chunk.replaceAll(sectionData, sectionSize);
+                break;
+
+            case sectionParameters: {
+                state.currentProgram = section.readInt();
+                const auto count = (juce::uint32)section.readInt();
+                if ((juce::int64)count * 4 > section.getNumBytesRemaining()) {
+                    return false;
+                }
+                state.parameters.clearQuick();
+                state.parameters.ensureStorageAllocated((int)count);
+                for (juce::uint32 i = 0; i < count; ++i) {
+                    state.parameters.add(section.readFloat());
+                }
+                state.hasParameters = true;
+                break;
+            }
+
+            case sectionRouting: {
+                const auto order = (juce::uint8)section.readByte();
+                const auto count = (juce::uint8)section.readByte();
+                if ((juce::int64)count * 9 > section.getNumBytesRemaining()) {
+                    return false;
+                }
+                state.routing.order = order == (juce::uint8)ChannelRouting::Order::film ? ChannelRouting::Order::film
+                                                                                        : ChannelRouting::Order::standard;
+                for (int ch = 0; ch < (int)count; ++ch) {
+                    const float inputTrimDb = section.readFloat();
+                    const float outputTrimDb = section.readFloat();
+                    const auto flags = (juce::uint8)section.readByte();
+
+                    // Channels beyond what this version supports are dropped
+                    if (ch < SpeakerLayout::maxChannels) {
+                        auto& channel = state.routing.channels[ch];
+                        channel.inputTrimDb = inputTrimDb;
+                        channel.outputTrimDb = outputTrimDb;
+                        channel.inputInverted = (flags & routingInputInverted) != 0;
+                        channel.outputInverted = (flags & routingOutputInverted) != 0;
+                    }
+                }
+                break;
+            }
+
+            default:
+                // Section from a newer version - skip it
+                break;
+        }
+
+        in.skipNextBytes(sectionSize);
+    }
+
+    return true;
+}
+
+bool readLegacyXml(const void* data, int sizeInBytes, WrapperState& state) {
+    std::unique_ptr<juce::XmlElement> xml(juce::AudioProcessor::getXmlFromBinary(data, sizeInBytes));
+    if (xml == nullptr || !xml->hasTagName("AltiverbSurroundWrapperState")) {
+        return false;
+    }
+
+    state.vst2Path = xml->getStringAttribute("vst2Path");
+    state.constantBlockMode = xml->getBoolAttribute("constantBlockMode", false);
+    state.engineLoaded = xml->getBoolAttribute("pluginLoaded", false);
+
+    if (xml->hasAttribute("vstState")) {
+        state.chunk.fromBase64Encoding(xml->getStringAttribute("vstState"));
+    }
+
+    if (auto* paramsXml = xml->getChildByName("Parameters")) {
+        state.hasParameters = true;
+        state.currentProgram = paramsXml->getIntAttribute("currentProgram", 0);
+
+        // param0..paramN-1, written without gaps
+        for (int i = 0; paramsXml->hasAttribute("param" + juce::String(i)); ++i) {
+            state.parameters.add((float)paramsXml->getDoubleAttribute("param" + juce::String(i), 0.0));
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+void write(const WrapperState& state, juce::MemoryBlock& destData, bool allowCompression) {
+    juce::MemoryOutputStream payload;
+    writePayload(state, payload);
+
+    juce::uint16 flags = 0;
+    juce::MemoryOutputStream compressed;
+
+    if (allowCompression && payload.getDataSize() >= compressionThreshold) {
+        {
+            juce::GZIPCompressorOutputStream zipper(compressed, 1);  // Fastest level
+            zipper.write(payload.getData(), payload.getDataSize());
+        }
+
+        // Chunks that are already compressed won't shrink - keep those raw
+        if (compressed.getDataSize() < payload.getDataSize()) {
+            flags |= flagCompressed;
+        }
+    }
+
+    const juce::MemoryOutputStream& body = (flags & flagCompressed) ? compressed : payload;
+
+    juce::MemoryOutputStream out(destData, false);
+    out.writeInt((int)magic);
+    out.writeShort((short)formatVersion);
+    out.writeShort((short)flags);
+    out.writeInt((int)body.getDataSize());
+    out.writeInt((int)payload.getDataSize());
+    out.write(body.getData(), body.getDataSize());
+}
+
+bool isBinaryState(const void* data, int sizeInBytes) {
+    if (data == nullptr || sizeInBytes < headerSize) {
+        return false;
+    }
+
+    return juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+bool read(const void* data, int sizeInBytes, WrapperState& state) {
+    state = WrapperState();
+
+    if (!isBinaryState(data, sizeInBytes)) {
+        return readLegacyXml(data, sizeInBytes, state);
+    }
+
+    juce::MemoryInputStream in(data, (size_t)sizeInBytes, false);
+    in.readInt();  // magic
+    const auto version = (juce::uint16)in.readShort();
+    const auto flags = (juce::uint16)in.readShort();
+    const auto payloadSize = (juce::uint32)in.readInt();
+    const auto rawSize = (juce::uint32)in.readInt();
+
+    if (version > formatVersion || (juce::int64)payloadSize > in.getNumBytesRemaining()) {
+        return false;
+    }
+
+    const char* payload = static_cast<const char*>(data) + headerSize;
+
+    if ((flags & flagCompressed) == 0) {
+        return readPayload(payload, payloadSize, state);
+    }
+
+    juce::MemoryBlock expanded;
+    {
+        juce::GZIPDecompressorInputStream unzipper(new juce::MemoryInputStream(payload, payloadSize, false), true,
+                                                   juce::GZIPDecompressorInputStream::zlibFormat, (juce::int64)rawSize);
+        if (unzipper.readIntoMemoryBlock(expanded, (juce::ssize_t)rawSize) != (size_t)rawSize) {
+            return false;
+        }
+    }
+
+    return readPayload(expanded.getData(), expanded.getSize(), state);
+}
+
+} // namespace StateContainer
@@ -0,0 +1,49 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ChannelRouting.h"
+
+// Everything the wrapper saves with a project
+struct WrapperState {
+    juce::String vst2Path;
+    bool constantBlockMode = false;
+    bool splitEngines = false;
+    bool pipelined = false;
+    bool engineLoaded = false;
+    ChannelRouting routing;
+
+    juce::MemoryBlock chunk;          // Altiverb's own chunk, stored as-is
+
+    bool hasParameters = false;
+    int currentProgram = 0;
+    juce::Array<float> parameters;    // Index = VST2 parameter index
+};
+
+// Binary project state (format 2).
+//
+//   Header   magic 'AVWS', u16 format version, u16 flags,
+//            u32 payload size, u32 uncompressed payload size
+//   Payload  sections: u32 id, u32 size, data - unknown ids are skipped
+//            'WRAP'  u8 flags, u32 path length, UTF-8 VST2 path
+//            'CHNK'  raw Altiverb chunk
+//            'PARM'  i32 current program, u32 count, count x f32
+//            'ROUT'  u8 order, u8 count, count x (f32 input trim dB,
+//                    f32 output trim dB, u8 polarity flags) - only when
+//                    the routing isn't a plain pass-through
+//
+// All integers are little-endian. The payload is optionally zlib-compressed
+// at the fastest level. read() also accepts the XML format written by
+// v1.0/v1.1 (base64 chunk plus one attribute per parameter).
+namespace StateContainer {
+
+constexpr juce::uint32 magic = 0x53575641;  // 'AVWS'
+constexpr juce::uint16 formatVersion = 2;
+
+// Payloads below this size are never compressed - not worth the time
+constexpr size_t compressionThreshold = 16 * 1024;
+
+void write(const WrapperState& state, juce::MemoryBlock& destData, bool allowCompression = true);
+bool read(const void* data, int sizeInBytes, WrapperState& state);
+
+bool isBinaryState(const void* data, int sizeInBytes);
+
+} // namespace StateContainer
@@ -0,0 +1,50 @@
+#include "StateRestorer.h"
+
+StateRestorer::StateRestorer(std::function<void()> restoreFunction)
+    : restore(std::move(restoreFunction))
+{
+    idle.signal();
+}
+
+StateRestorer::~StateRestorer() {
+    // The job refers to us - it must be off the pool before we go away
+    waitUntilIdle();
+    sharedPool->pool.waitForJobToFinish(&job, -1);
+}
+
+void StateRestorer::schedule() {
+    const juce::ScopedLock sl(lock);
+
+    requested = true;
+    busy.store(true, std::memory_order_seq_cst);
+    idle.reset();
+
+    if (!jobQueued) {
+        jobQueued = true;
+        sharedPool->pool.addJob(&job, false);
+    }
+}
+
+void StateRestorer::waitUntilIdle() {
+    idle.wait(-1);
+}
+
+juce::ThreadPoolJob::JobStatus StateRestorer::Job::runJob() {
+    for (;;) {
+        {
+            const juce::ScopedLock sl(restorer.lock);
+
+            // Nothing new since the last pass - done
+            if (!restorer.requested) {
+                restorer.jobQueued = false;
+                restorer.busy.store(false, std::memory_order_seq_cst);
+                restorer.idle.signal();
+                return jobHasFinished;
+            }
+
+            restorer.requested = false;
+        }
+
+        restorer.restore();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+// Runs a processor's state restore off the host's thread.
+//
+// schedule() returns immediately. The restore runs as a job on a thread
+// pool shared by every wrapper instance, so a project with many instances
+// restores them side by side instead of one after another. Requests that
+// arrive while a restore is queued or running are coalesced: the restore
+// function runs again afterwards and picks up the latest state.
+class StateRestorer {
+public:
+    explicit StateRestorer(std::function<void()> restoreFunction);
+    ~StateRestorer();
+
+    void schedule();
+
+    // True from schedule() until the last requested restore has finished.
+    // Cheap enough for the audio thread. Sequentially consistent: the audio
+    // thread pairs it with its own in-use flag, and neither may be reordered
+    // before the other's store.
+    bool isBusy() const noexcept { return busy.load(std::memory_order_seq_cst); }
+
+    void waitUntilIdle();
+
+private:
+    struct SharedPool {
+        juce::ThreadPool pool { juce::ThreadPoolOptions()
+                                    .withThreadName("Altiverb Restore")
+                                    .withNumberOfThreads(juce::jlimit(2, 8, juce::SystemStats::getNumCpus())) };
+    };
+
+    class Job : public juce::ThreadPoolJob {
+    public:
+        explicit Job(StateRestorer& owner) : juce::ThreadPoolJob("Altiverb Restore"), restorer(owner) {}
+        JobStatus runJob() override;
+
+    private:
+        StateRestorer& restorer;
+    };
+
+    std::function<void()> restore;
+    juce::SharedResourcePointer<SharedPool> sharedPool;
+    Job job { *this };
+
+    juce::CriticalSection lock;
+    bool jobQueued = false;   // Guarded by lock
+    bool requested = false;   // Guarded by lock
+    std::atomic<bool> busy { false };
+    juce::WaitableEvent idle { true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StateRestorer)
+};
@@ -0,0 +1,108 @@
+#include "StateSnapshotCache.h"
+
+StateSnapshotCache::StateSnapshotCache(ChangeCounter changeCounter, Serialiser serialiser)
+    : getChangeCount(std::move(changeCounter)),
+      serialise(std::move(serialiser))
+{
+    refresher->add(this);
+}
+
+StateSnapshotCache::~StateSnapshotCache() {
+    // Waits for a background pass that may be serialising this instance
+    refresher->remove(this);
+}
+
+bool StateSnapshotCache::getIfCurrent(juce::MemoryBlock& dest) const {
+    const juce::ScopedLock sl(snapshotLock);
+
+    if (!hasSnapshot || snapshotVersion != getChangeCount()) {
+        return false;
+    }
+
+    dest = snapshot;
+    return true;
+}
+
+bool StateSnapshotCache::refresh(juce::MemoryBlock& dest) {
+    // Read the counter first - a change during serialisation leaves the snapshot stale
+    const juce::uint32 version = getChangeCount();
+
+    juce::MemoryBlock fresh;
+    if (!serialise(fresh)) {
+        return false;
+    }
+
+    dest = fresh;
+
+    const juce::ScopedLock sl(snapshotLock);
+
+    // Don't replace a snapshot another thread took later than this one
+    if (!hasSnapshot || (juce::int32)(version - snapshotVersion) >= 0) {
+        snapshot.swapWith(fresh);
+        snapshotVersion = version;
+        hasSnapshot = true;
+    }
+
+    return true;
+}
+
+void StateSnapshotCache::invalidate() {
+    const juce::ScopedLock sl(snapshotLock);
+    snapshot.reset();
+    hasSnapshot = false;
+}
+
+void StateSnapshotCache::refreshIfSettled() {
+    const juce::uint32 count = getChangeCount();
+
+    {
+        const juce::ScopedLock sl(snapshotLock);
+        if (hasSnapshot && snapshotVersion == count) {
+            lastSeenCount = count;
+            return;
+        }
+    }
+
+    // Still changing (automation, a knob being dragged) - wait for it to settle
+    if (count != lastSeenCount) {
+        lastSeenCount = count;
+        return;
+    }
+
+    juce::MemoryBlock unused;
+    refresh(unused);
+}
+
+StateSnapshotCache::SharedRefresher::SharedRefresher()
+    : juce::Thread("Altiverb Snapshot")
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+StateSnapshotCache::SharedRefresher::~SharedRefresher() {
+    stopThread(10000);
+}
+
+void StateSnapshotCache::SharedRefresher::add(StateSnapshotCache* cache) {
+    const juce::ScopedLock sl(lock);
+    caches.add(cache);
+}
+
+void StateSnapshotCache::SharedRefresher::remove(StateSnapshotCache* cache) {
+    const juce::ScopedLock sl(lock);
+    caches.removeFirstMatchingValue(cache);
+}
+
+void StateSnapshotCache::SharedRefresher::run() {
+    while (!threadShouldExit()) {
+        wait(refreshIntervalMs);
+
+        const juce::ScopedLock sl(lock);
+        for (auto* cache : caches) {
+            if (threadShouldExit()) {
+                break;
+            }
+            cache->refreshIfSettled();
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+
+// Keeps the last serialized project state so an unchanged instance answers
+// getStateInformation without calling into Altiverb.
+//
+// The owner supplies a change counter that is bumped (lock-free, from any
+// thread) whenever the engine's state may have changed, and a serialiser.
+// A snapshot records the counter value it was taken at and stays current
+// until the counter moves. Stale snapshots are re-serialized by one
+// background thread shared by every instance, once the counter has stopped
+// moving for a tick, so a save normally finds a current snapshot waiting.
+class StateSnapshotCache {
+public:
+    using ChangeCounter = std::function<juce::uint32()>;
+    using Serialiser = std::function<bool(juce::MemoryBlock&)>;  // False: nothing worth caching
+
+    StateSnapshotCache(ChangeCounter changeCounter, Serialiser serialiser);
+    ~StateSnapshotCache();
+
+    // Copy the snapshot into dest if nothing has changed since it was taken
+    bool getIfCurrent(juce::MemoryBlock& dest) const;
+
+    // Serialise on the caller's thread, keep the result and copy it into dest.
+    // Returns false if the serialiser had nothing to give.
+    bool refresh(juce::MemoryBlock& dest);
+
+    // Drop the snapshot (engine unloaded, state replaced)
+    void invalidate();
+
+    // How long the counter must stay still before a background refresh
+    static constexpr int refreshIntervalMs = 250;
+
+private:
+    class SharedRefresher : private juce::Thread {
+    public:
+        SharedRefresher();
+        ~SharedRefresher() override;
+
+        void add(StateSnapshotCache* cache);
+        void remove(StateSnapshotCache* cache);
+
+    private:
+        juce::CriticalSection lock;  // Held for a whole pass, so remove() waits for it
+        juce::Array<StateSnapshotCache*> caches;
+
+        void run() override;
+    };
+
+    ChangeCounter getChangeCount;
+    Serialiser serialise;
+
+    juce::CriticalSection snapshotLock;
+    juce::MemoryBlock snapshot;          // Guarded by snapshotLock
+    juce::uint32 snapshotVersion = 0;    // Guarded by snapshotLock
+    bool hasSnapshot = false;            // Guarded by snapshotLock
+
+    juce::uint32 lastSeenCount = 0;      // Refresher thread only
+
+    juce::SharedResourcePointer<SharedRefresher> refresher;
+
+    void refreshIfSettled();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StateSnapshotCache)
+};
@@ -0,0 +1,54 @@
+#include "SubBlockScheduler.h"
+
+void SubBlockScheduler::reserve(ScratchArena& arena, bool useConstantBlocks, bool shouldPipeline, int channels, int blockSize) {
+    constantBlockMode = useConstantBlocks || shouldPipeline;
+    pipelined = shouldPipeline;
+    numChannels = juce::jlimit(0, maxChannels, channels);
+    constantBlockSize = juce::jmax(1, blockSize);
+    numBufferSets = constantBlockMode ? (pipelined ? 4 : 2) : 0;
+    fifoInputs = nullptr;
+    fifoOutputs = nullptr;
+    engineInputs = nullptr;
+    engineOutputs = nullptr;
+    
+    const size_t channelBytes = sizeof(float) * (size_t)constantBlockSize;
+    
+    for (int set = 0; set < numBufferSets; ++set) {
+        ptrsOffsets[set] = arena.reserveArray<float*>(maxChannels);
+        
+        for (int ch = 0; ch < numChannels; ++ch) {
+            channelOffsets[set][ch] = arena.reserve(channelBytes);
+        }
+    }
+}
+
+void SubBlockScheduler::attach(const ScratchArena& arena) {
+    float** sets[maxBufferSets] = {};
+    
+    for (int set = 0; set < numBufferSets; ++set) {
+        sets[set] = arena.getArray<float*>(ptrsOffsets[set]);
+        
+        for (int ch = 0; ch < numChannels; ++ch) {
+            sets[set][ch] = arena.getArray<float>(channelOffsets[set][ch]);
+        }
+    }
+    
+    fifoInputs = sets[0];
+    fifoOutputs = sets[1];
+    engineInputs = sets[2];
+    engineOutputs = sets[3];
+    
+    reset();
+}
+
+void SubBlockScheduler::reset() {
+    fifoPosition = 0;
+    
+    float** sets[maxBufferSets] = { fifoInputs, fifoOutputs, engineInputs, engineOutputs };
+    
+    for (int set = 0; set < numBufferSets; ++set) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            juce::FloatVectorOperations::clear(sets[set][ch], constantBlockSize);
+        }
+    }
+}
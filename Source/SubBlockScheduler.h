@@ -0,0 +1,105 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ScratchArena.h"
+
+// Feeds the engine well-formed blocks regardless of how the host slices them.
+// Split mode cuts host blocks into chunks no larger than the prepared size.
+// Constant-block mode runs a FIFO so the engine always gets full blocks of
+// the same size, at the cost of one block of latency. Pipelined, the FIFO
+// has a second pair of buffers so a block can be processed elsewhere while
+// the next one is buffered - for the same block of latency.
+class SubBlockScheduler {
+public:
+    static constexpr int maxChannels = 12;  // Up to 7.1.4
+    
+    SubBlockScheduler() = default;
+    
+    // Preparation (message thread) - reserve() before the arena is allocated, attach() after
+    void reserve(ScratchArena& arena, bool useConstantBlocks, bool pipelined, int numChannels, int blockSize);
+    void attach(const ScratchArena& arena);
+    void reset();
+    
+    bool isConstantBlockMode() const noexcept { return constantBlockMode; }
+    bool isPipelined() const noexcept { return pipelined; }
+    int getLatencySamples() const noexcept { return constantBlockMode ? constantBlockSize : 0; }
+    
+    // Split mode: fn(startSample, numSamples) for each chunk of at most maxChunkSize
+    template <typename ChunkFn>
+    static void forEachChunk(int numSamples, int maxChunkSize, ChunkFn&& fn) {
+        for (int startSample = 0; startSample < numSamples; startSample += maxChunkSize) {
+            fn(startSample, juce::jmin(maxChunkSize, numSamples - startSample));
+        }
+    }
+    
+    // Constant-block mode: fn(inputs, outputs, blockSize) whenever a full block is buffered
+    template <typename BlockFn>
+    void processConstantBlocks(juce::AudioBuffer<float>& buffer, BlockFn&& fn) {
+        runFifo(buffer, [] {}, [&] { fn(fifoInputs, fifoOutputs, constantBlockSize); });
+    }
+    
+    // Pipelined: submit(inputs, outputs, blockSize) hands a full block over, and
+    // waitForBlock() must return once the last one handed over has been processed.
+    // The result is collected just before the FIFO starts playing it out.
+    template <typename WaitFn, typename SubmitFn>
+    void processPipelinedBlocks(juce::AudioBuffer<float>& buffer, WaitFn&& waitForBlock, SubmitFn&& submit) {
+        runFifo(buffer,
+                [&] {
+                    waitForBlock();
+                    std::swap(fifoOutputs, engineOutputs);
+                },
+                [&] {
+                    std::swap(fifoInputs, engineInputs);
+                    submit(engineInputs, engineOutputs, constantBlockSize);
+                });
+    }
+    
+private:
+    bool constantBlockMode = false;
+    bool pipelined = false;
+    int numChannels = 0;
+    int constantBlockSize = 0;
+    int fifoPosition = 0;
+    
+    float** fifoInputs = nullptr;
+    float** fifoOutputs = nullptr;
+    float** engineInputs = nullptr;   // Pipelined: the block in flight
+    float** engineOutputs = nullptr;
+    
+    // FIFO inputs, FIFO outputs, then the in-flight pair when pipelined
+    static constexpr int maxBufferSets = 4;
+    int numBufferSets = 0;
+    size_t ptrsOffsets[maxBufferSets] = {};
+    size_t channelOffsets[maxBufferSets][maxChannels] = {};
+    
+    // onBlockStart() before the first sample of each block, onBlockFull() once it is complete
+    template <typename StartFn, typename FullFn>
+    void runFifo(juce::AudioBuffer<float>& buffer, StartFn&& onBlockStart, FullFn&& onBlockFull) {
+        const int numSamples = buffer.getNumSamples();
+        const int numBufferChannels = juce::jmin(numChannels, buffer.getNumChannels());
+        
+        for (int startSample = 0; startSample < numSamples;) {
+            if (fifoPosition == 0) {
+                onBlockStart();
+            }
+            
+            const int count = juce::jmin(constantBlockSize - fifoPosition, numSamples - startSample);
+            
+            // Host buffer is in-place: take the input before writing the delayed output
+            for (int ch = 0; ch < numBufferChannels; ++ch) {
+                float* hostChannel = buffer.getWritePointer(ch, startSample);
+                juce::FloatVectorOperations::copy(fifoInputs[ch] + fifoPosition, hostChannel, count);
+                juce::FloatVectorOperations::copy(hostChannel, fifoOutputs[ch] + fifoPosition, count);
+            }
+            
+            fifoPosition += count;
+            startSample += count;
+            
+            if (fifoPosition == constantBlockSize) {
+                onBlockFull();
+                fifoPosition = 0;
+            }
+        }
+    }
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SubBlockScheduler)
+};
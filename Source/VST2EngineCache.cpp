@@ -0,0 +1,169 @@
+#include "VST2EngineCache.h"
+
+#if !JUCE_WINDOWS
+  #include <dlfcn.h>
+#endif
+
+#if JUCE_WINDOWS
+
+VST2EngineCache::ModuleHandle VST2EngineCache::openModule(const juce::String& path) {
+    return LoadLibraryA(path.toRawUTF8());
+}
+
+void* VST2EngineCache::findSymbol(ModuleHandle module, const char* name) {
+    return (void*)GetProcAddress(module, name);
+}
+
+void VST2EngineCache::closeModule(ModuleHandle module) {
+    FreeLibrary(module);
+}
+
+#else
+
+VST2EngineCache::ModuleHandle VST2EngineCache::openModule(const juce::String& path) {
+    // RTLD_LOCAL keeps each plugin's symbols out of the global namespace
+    return dlopen(path.toRawUTF8(), RTLD_NOW | RTLD_LOCAL);
+}
+
+void* VST2EngineCache::findSymbol(ModuleHandle module, const char* name) {
+    return dlsym(module, name);
+}
+
+void VST2EngineCache::closeModule(ModuleHandle module) {
+    dlclose(module);
+}
+
+#endif
+
+VST2EngineCache::Module::~Module() {
+    // Pooled effects were never handed out - close them before the binary goes away
+    for (auto* effect : warmEffects) {
+        effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
+    }
+    warmEffects.clear();
+
+    if (handle) {
+        closeModule(handle);
+    }
+}
+
+VST2EngineCache::VST2EngineCache()
+    : juce::Thread("VST2 Engine Pool")
+{
+}
+
+VST2EngineCache::~VST2EngineCache() {
+    stopThread(10000);
+
+    const juce::ScopedLock sl(lock);
+    modules.clear();
+}
+
+VST2EngineCache::ModulePtr VST2EngineCache::acquireModule(const juce::String& path) {
+    {
+        const juce::ScopedLock sl(lock);
+        for (auto* module : modules) {
+            if (module->path == path) {
+                return module;
+            }
+        }
+    }
+
+    // Load outside the lock so other instances can still take warm effects
+    ModuleHandle handle = openModule(path);
+    if (!handle) {
+        return nullptr;
+    }
+
+    auto entryPoint = (VSTPluginMainProc)findSymbol(handle, "VSTPluginMain");
+    if (!entryPoint) {
+        entryPoint = (VSTPluginMainProc)findSymbol(handle, "main");
+    }
+
+    if (!entryPoint) {
+        closeModule(handle);
+        return nullptr;
+    }
+
+    ModulePtr module;
+    {
+        const juce::ScopedLock sl(lock);
+
+        // Another instance may have loaded the same binary meanwhile
+        for (auto* existing : modules) {
+            if (existing->path == path) {
+                module = existing;
+                break;
+            }
+        }
+
+        if (!module) {
+            module = new Module();
+            module->path = path;
+            module->handle = handle;
+            module->entryPoint = entryPoint;
+            modules.add(module);
+            handle = nullptr;
+        }
+    }
+
+    // Drop the extra reference the OS counted for us
+    if (handle) {
+        closeModule(handle);
+    }
+
+    if (!isThreadRunning()) {
+        startThread(juce::Thread::Priority::low);
+    }
+    notify();
+
+    return module;
+}
+
+AEffect* VST2EngineCache::takeWarmEffect(Module& module) {
+    AEffect* effect = nullptr;
+    {
+        const juce::ScopedLock sl(lock);
+        if (!module.warmEffects.empty()) {
+            effect = module.warmEffects.back();
+            module.warmEffects.pop_back();
+        }
+    }
+
+    notify();
+    return effect;
+}
+
+VST2EngineCache::ModulePtr VST2EngineCache::findModuleNeedingEffects() {
+    const juce::ScopedLock sl(lock);
+    for (auto* module : modules) {
+        if (!module->prefillFailed && (int)module->warmEffects.size() < warmEffectsPerModule) {
+            return module;
+        }
+    }
+    return nullptr;
+}
+
+void VST2EngineCache::run() {
+    while (!threadShouldExit()) {
+        ModulePtr module = findModuleNeedingEffects();
+
+        if (!module || !effectFactory.load()) {
+            wait(-1);
+            continue;
+        }
+
+        // Opening can take a while - don't hold the lock for it
+        AEffect* effect = effectFactory.load()(module->entryPoint);
+
+        const juce::ScopedLock sl(lock);
+
+        if (!effect) {
+            // This binary won't open off the message thread - instances fall back to a cold start
+            module->prefillFailed = true;
+            continue;
+        }
+
+        module->warmEffects.push_back(effect);
+    }
+}
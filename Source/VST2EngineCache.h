@@ -0,0 +1,75 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <vector>
+#include "VST2Types.h"
+
+#if JUCE_WINDOWS
+  #include <Windows.h>
+#endif
+
+// Process-wide cache shared by every VST2Loader (through SharedResourcePointer).
+//
+// Each plugin binary is loaded and its entry point resolved once per process.
+// For every cached module a background thread keeps a few effects opened and
+// negotiated to 5.1, so a new wrapper instance takes one from the pool instead
+// of paying effOpen and the speaker-arrangement rounds itself.
+class VST2EngineCache : private juce::Thread {
+public:
+    #if JUCE_WINDOWS
+    using ModuleHandle = HMODULE;
+    #else
+    using ModuleHandle = void*;  // dlopen handle
+    #endif
+
+    // Opens, negotiates and returns a ready effect (defined by VST2Loader)
+    using EffectFactory = AEffect* (*)(VSTPluginMainProc);
+
+    class Module : public juce::ReferenceCountedObject {
+    public:
+        ~Module() override;
+
+        const juce::String& getPath() const noexcept { return path; }
+        VSTPluginMainProc getEntryPoint() const noexcept { return entryPoint; }
+
+    private:
+        friend class VST2EngineCache;
+
+        juce::String path;
+        ModuleHandle handle = nullptr;
+        VSTPluginMainProc entryPoint = nullptr;
+        std::vector<AEffect*> warmEffects;  // Guarded by the cache lock
+        bool prefillFailed = false;
+    };
+
+    using ModulePtr = juce::ReferenceCountedObjectPtr<Module>;
+
+    // Effects kept ready per module
+    static constexpr int warmEffectsPerModule = 2;
+
+    VST2EngineCache();
+    ~VST2EngineCache() override;
+
+    // Load (or find) a module; nullptr if the binary can't be loaded or has no entry point
+    ModulePtr acquireModule(const juce::String& path);
+
+    // Hand over a pre-opened effect, or nullptr if none is ready yet.
+    // The pool is refilled in the background either way.
+    AEffect* takeWarmEffect(Module& module);
+
+    void setEffectFactory(EffectFactory factory) noexcept { effectFactory = factory; }
+
+private:
+    juce::CriticalSection lock;
+    juce::ReferenceCountedArray<Module> modules;
+    std::atomic<EffectFactory> effectFactory { nullptr };
+
+    void run() override;
+    ModulePtr findModuleNeedingEffects();
+
+    static ModuleHandle openModule(const juce::String& path);
+    static void* findSymbol(ModuleHandle module, const char* name);
+    static void closeModule(ModuleHandle module);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VST2EngineCache)
+};
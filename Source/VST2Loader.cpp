@@ -1,14 +1,28 @@
 #include "VST2Loader.h"
 
-AudioMasterCallback VST2Loader::originalHostCallback = nullptr;
+namespace {
 
-// Static speaker arrangements for 5.1 setup
-VstSpeakerArrangement VST2Loader::inputArrangement;
-VstSpeakerArrangement VST2Loader::outputArrangement;
+// Set while a loader opens an effect on this thread, before it can be attached
+thread_local VST2Loader* loaderOpeningEffect = nullptr;
+
+// Answered to plugins that have no owner yet (opened by the pool)
+const VstSpeakerArrangement& getDefaultArrangement() {
+    static const VstSpeakerArrangement arrangement = [] {
+        VstSpeakerArrangement result {};
+        SpeakerLayout::getDefault().fillArrangement(result);
+        return result;
+    }();
+    return arrangement;
+}
+
+} // namespace
 
 VST2Loader::VST2Loader() {
-    setup51Arrangement(inputArrangement);
-    setup51Arrangement(outputArrangement);
+    SpeakerLayout::getDefault().fillArrangement(inputArrangement);
+    SpeakerLayout::getDefault().fillArrangement(outputArrangement);
+    
+    // Pooled effects are opened and negotiated exactly like cold-started ones
+    engineCache->setEffectFactory(&VST2Loader::openEffect);
 }
 
 VST2Loader::~VST2Loader() {
@@ -20,23 +34,9 @@ VST2Loader::~VST2Loader() {
     }
 }
 
-void VST2Loader::setup51Arrangement(VstSpeakerArrangement& arrangement) {
-    arrangement.type = kSpeakerArr51;
-    arrangement.numChannels = 6;
-    
-    // L, R, C, LFE, Ls, Rs
-    const char* names[6] = { "L", "R", "C", "LFE", "Ls", "Rs" };
-    const float azimuths[6] = { -30.0f, 30.0f, 0.0f, 0.0f, -110.0f, 110.0f };
-    
-    for (int i = 0; i < 6; ++i) {
-        arrangement.speakers[i].azimuth = azimuths[i];
-        arrangement.speakers[i].elevation = 0.0f;
-        arrangement.speakers[i].radius = 1.0f;
-        arrangement.speakers[i].reserved = 0.0f;
-        strncpy(arrangement.speakers[i].name, names[i], 63);
-        arrangement.speakers[i].name[63] = 0;
-        arrangement.speakers[i].type = i;
-    }
+void VST2Loader::copyArrangementForPlugin(const VstSpeakerArrangement& arrangement, void* destination) {
+    const int numSpeakers = juce::jlimit(0, vstSdkMaxSpeakers, (int)arrangement.numChannels);
+    std::memcpy(destination, &arrangement, offsetof(VstSpeakerArrangement, speakers) + numSpeakers * sizeof(VstSpeakerProperties));
 }
 
 VstIntPtr VSTCALLBACK VST2Loader::hostCallback(AEffect* effect, VstInt32 opcode, 
@@ -47,27 +47,73 @@ VstIntPtr VSTCALLBACK VST2Loader::hostCallback(AEffect* effect, VstInt32 opcode,
             return 2400;  // VST 2.4
             
         case audioMasterAutomate:
+            // A knob moved in Altiverb's editor - queue it for the host, snapshot is stale now
+            if (auto* loader = fromEffect(effect)) {
+                loader->editQueue.push(PluginEdit::Type::valueChanged, index, opt);
+                loader->metadata.invalidateParameterText(index);
+                loader->markStateChanged();
+            }
             return 0;
             
+        case audioMasterBeginEdit:
+            if (auto* loader = fromEffect(effect)) {
+                loader->editQueue.push(PluginEdit::Type::gestureBegin, index, 0.0f);
+            }
+            return 1;
+            
+        case audioMasterEndEdit:
+            if (auto* loader = fromEffect(effect)) {
+                loader->editQueue.push(PluginEdit::Type::gestureEnd, index, 0.0f);
+                loader->markStateChanged();
+            }
+            return 1;
+            
+        case audioMasterUpdateDisplay:
+            // Program change or similar - the owner rereads every value
+            if (auto* loader = fromEffect(effect)) {
+                loader->editQueue.push(PluginEdit::Type::displayChanged, 0, 0.0f);
+                loader->metadata.invalidateAll();
+                loader->markStateChanged();
+            }
+            return 1;
+            
         case audioMasterGetTime:
+            // The owner's current transport - none before it has processed a block. The
+            // copy stays valid until this thread asks again, as a VST2 host's pointer does.
+            if (auto* loader = fromEffect(effect)) {
+                thread_local VstTimeInfo info;
+                loader->readTimeInfo(info);
+                return info.sampleRate > 0.0 ? (VstIntPtr)&info : 0;
+            }
             return 0;
             
-        case audioMasterIOChanged:
-            return 1;
+        case audioMasterGetSampleRate:
+            if (auto* loader = fromEffect(effect)) {
+                return (VstIntPtr)loader->hostSampleRate.load(std::memory_order_relaxed);
+            }
+            return 0;
             
-        case audioMasterGetInputSpeakerArrangement:
-            if (ptr) {
-                VstSpeakerArrangement* arrangement = static_cast<VstSpeakerArrangement*>(ptr);
-                *arrangement = VST2Loader::getInputArrangement();
+        case audioMasterGetBlockSize:
+            if (auto* loader = fromEffect(effect)) {
+                return loader->hostBlockSize.load(std::memory_order_relaxed);
             }
+            return 0;
+            
+        case audioMasterIOChanged:
             return 1;
             
-        case audioMasterGetOutputSpeakerArrangement:
+        case audioMasterGetInputSpeakerArrangement:
+        case audioMasterGetOutputSpeakerArrangement: {
+            // The SDK returns a pointer to the host's arrangement; older plugins pass a struct to fill
+            auto* loader = fromEffect(effect);
+            const auto& arrangement = loader == nullptr ? getDefaultArrangement()
+                                    : opcode == audioMasterGetInputSpeakerArrangement ? loader->inputArrangement
+                                                                                      : loader->outputArrangement;
             if (ptr) {
-                VstSpeakerArrangement* arrangement = static_cast<VstSpeakerArrangement*>(ptr);
-                *arrangement = VST2Loader::getOutputArrangement();
+                copyArrangementForPlugin(arrangement, ptr);
             }
-            return 1;
+            return (VstIntPtr)&arrangement;
+        }
             
         case audioMasterCanDo:
             if (ptr) {
@@ -92,7 +138,11 @@ VstIntPtr VSTCALLBACK VST2Loader::hostCallback(AEffect* effect, VstInt32 opcode,
             return 0;
             
         case audioMasterGetCurrentProcessLevel:
-            return 0;
+            // Offline while the host bounces or freezes, unknown otherwise
+            if (auto* loader = fromEffect(effect)) {
+                return loader->processLevel.load(std::memory_order_relaxed);
+            }
+            return kVstProcessLevelUnknown;
             
         case audioMasterGetAutomationState:
             return 0;
@@ -123,29 +173,78 @@ VstIntPtr VSTCALLBACK VST2Loader::hostCallback(AEffect* effect, VstInt32 opcode,
 bool VST2Loader::loadPlugin(const juce::String& path) {
     unloadPlugin();
     
-    // Load the VST2 DLL
-    pluginModule = LoadLibraryA(path.toRawUTF8());
-    if (!pluginModule) {
-        return false;
+    // Bridged: the helper process loads, opens and negotiates the plugin
+    if (useBridge) {
+        bridgeClient = std::make_unique<BridgeClient>();
+        effect = bridgeClient->attach(path);
+        
+        if (!effect) {
+            bridgeClient.reset();
+            return false;
+        }
+        
+        metadata.build(effect);
+        wantsSurround = true;
+        pluginPath = path;
+        markStateChanged();
+        return true;
     }
     
-    // Get the main entry point
-    typedef AEffect* (*MainEntryPoint)(AudioMasterCallback);
-    MainEntryPoint mainEntry;
-    
-    mainEntry = (MainEntryPoint)GetProcAddress(pluginModule, "VSTPluginMain");
+    // Load the VST2 binary (once per process) and resolve its entry point
+    module = engineCache->acquireModule(path);
+    if (!module) {
+        return false;
+    }
     
-    if (!mainEntry) {
-        mainEntry = (MainEntryPoint)GetProcAddress(pluginModule, "main");
+    // Prefer an effect the pool already opened and negotiated, otherwise start one cold
+    effect = engineCache->takeWarmEffect(*module);
+    if (!effect) {
+        const juce::ScopedValueSetter<VST2Loader*> opening(loaderOpeningEffect, this);
+        effect = openEffect(module->getEntryPoint());
     }
     
-    if (!mainEntry) {
-        FreeLibrary(pluginModule);
-        pluginModule = nullptr;
+    if (!effect) {
+        module = nullptr;
         return false;
     }
     
+    attachToEffect();
+    wantsSurround = true;
+    pluginPath = path;
+    return true;
+}
+
+bool VST2Loader::loadFromEntryPoint(VSTPluginMainProc mainEntry) {
+    unloadPlugin();
+    
+    {
+        const juce::ScopedValueSetter<VST2Loader*> opening(loaderOpeningEffect, this);
+        effect = mainEntry != nullptr ? openEffect(mainEntry) : nullptr;
+    }
+    if (effect) {
+        attachToEffect();
+    }
+    wantsSurround = effect != nullptr;
+    return effect != nullptr;
+}
+
+void VST2Loader::attachToEffect() {
+    // resvd1 is reserved for the host; only our callback reads it
+    effect->resvd1 = (VstIntPtr)this;
+    metadata.build(effect);
+    markStateChanged();
+}
+
+VST2Loader* VST2Loader::fromEffect(AEffect* effect) {
+    if (effect != nullptr && effect->resvd1 != 0) {
+        return reinterpret_cast<VST2Loader*>(effect->resvd1);
+    }
+    return loaderOpeningEffect;
+}
+
+AEffect* VST2Loader::openEffect(VSTPluginMainProc mainEntry) {
     // Create the effect with our intercepting callback
+    AEffect* effect = nullptr;
     try {
         effect = mainEntry(hostCallback);
     }
@@ -154,9 +253,7 @@ bool VST2Loader::loadPlugin(const juce::String& path) {
     }
     
     if (!effect) {
-        FreeLibrary(pluginModule);
-        pluginModule = nullptr;
-        return false;
+        return nullptr;
     }
     
     // Validate magic number (but continue even if it fails for compatibility)
@@ -173,50 +270,59 @@ bool VST2Loader::loadPlugin(const juce::String& path) {
     }
     
     // Set speaker arrangement to 5.1
-    VstSpeakerArrangement inputs, outputs;
-    setup51Arrangement(inputs);
-    setup51Arrangement(outputs);
+    const SpeakerLayout& layout = SpeakerLayout::getDefault();
+    VstSpeakerArrangement inputs {}, outputs {};
+    layout.fillArrangement(inputs);
+    layout.fillArrangement(outputs);
     
     VstIntPtr result = effect->dispatcher(effect, effSetSpeakerArrangement, 0, 
                                          (VstIntPtr)&inputs, &outputs, 0.0f);
     
     if (result == 1) {
-        wantsSurround = true;
         // Update effect's I/O counts to reflect 5.1
-        effect->numInputs = 6;
-        effect->numOutputs = 6;
+        effect->numInputs = layout.numChannels;
+        effect->numOutputs = layout.numChannels;
     } else {
         // Try alternative approach - force the I/O configuration
-        effect->numInputs = 6;
-        effect->numOutputs = 6;
+        effect->numInputs = layout.numChannels;
+        effect->numOutputs = layout.numChannels;
         
         // Try calling the speaker arrangement again after forcing I/O
         result = effect->dispatcher(effect, effSetSpeakerArrangement, 0, 
                                    (VstIntPtr)&inputs, &outputs, 0.0f);
         
-        // Force surround mode regardless of result since our wrapper handles 6 channels
-        wantsSurround = true;
+        // Surround mode is forced regardless of result since our wrapper handles the channels
     }
     
     // Additional enforcement - call canDo checks to trigger more callbacks
     effect->dispatcher(effect, effCanDo, 0, 0, (void*)"sendVstSpeakerArrangement", 0.0f);
     effect->dispatcher(effect, effCanDo, 0, 0, (void*)"receiveVstSpeakerProperties", 0.0f);
     
-    return true;
+    return effect;
 }
 
 void VST2Loader::unloadPlugin() {
+    if (bridgeClient) {
+        // The helper closes the real effect when the channel is detached
+        closeEditor();
+        suspend();
+        bridgeClient.reset();
+        effect = nullptr;
+    }
+    
     if (effect) {
         closeEditor();
         suspend();
+        effect->resvd1 = 0;
         effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
         effect = nullptr;
+        markStateChanged();
     }
     
-    if (pluginModule) {
-        FreeLibrary(pluginModule);
-        pluginModule = nullptr;
-    }
+    // The binary stays loaded while the cache or another instance holds it
+    module = nullptr;
+    metadata.clear();
+    pluginPath = {};
 }
 
 void VST2Loader::processReplacing(float** inputs, float** outputs, int sampleFrames) {
@@ -225,9 +331,30 @@ void VST2Loader::processReplacing(float** inputs, float** outputs, int sampleFra
     }
 }
 
+void VST2Loader::processDoubleReplacing(double** inputs, double** outputs, int sampleFrames) {
+    if (effect && effect->processDoubleReplacing) {
+        effect->processDoubleReplacing(effect, inputs, outputs, sampleFrames);
+    }
+}
+
+bool VST2Loader::canProcessDouble() const {
+    // Bridged engines have no double path - the proxy only carries float audio
+    return effect && (effect->flags & effFlagsCanDoubleReplacing) != 0 && effect->processDoubleReplacing != nullptr;
+}
+
+bool VST2Loader::setProcessPrecision(bool use64Bit) {
+    if (!effect) return false;
+    
+    VstIntPtr result = effect->dispatcher(effect, effSetProcessPrecision, 0,
+                                         use64Bit ? kVstProcessPrecision64 : kVstProcessPrecision32, nullptr, 0.0f);
+    return result == 1;
+}
+
 void VST2Loader::setParameter(int index, float value) {
     if (effect && effect->setParameter) {
         effect->setParameter(effect, index, value);
+        metadata.invalidateParameterText(index);
+        markStateChanged();  // After the call, so a snapshot taken meanwhile is seen as stale
     }
 }
 
@@ -243,19 +370,15 @@ int VST2Loader::getNumParameters() const {
 }
 
 juce::String VST2Loader::getParameterName(int index) {
-    if (!effect) return "";
-    
-    char name[256] = {0};
-    effect->dispatcher(effect, effGetParamName, index, 0, name, 0.0f);
-    return juce::String(name);
+    return metadata.getParameterName(index);
+}
+
+juce::String VST2Loader::getParameterLabel(int index) {
+    return metadata.getParameterLabel(index);
 }
 
 juce::String VST2Loader::getParameterText(int index) {
-    if (!effect) return "";
-    
-    char text[256] = {0};
-    effect->dispatcher(effect, effGetParamDisplay, index, 0, text, 0.0f);
-    return juce::String(text);
+    return metadata.getParameterText(effect, index);
 }
 
 bool VST2Loader::hasEditor() const {
@@ -276,6 +399,7 @@ void* VST2Loader::openEditor(void* parentWindow) {
         
         if (result != 0) {
             editorWindow = parentWindow;
+            markStateChanged();
             return editorWindow;
         }
         return nullptr;
@@ -295,6 +419,7 @@ void VST2Loader::closeEditor() {
         }
         
         editorWindow = nullptr;
+        markStateChanged();  // Whatever was edited is final now
     }
 }
 
@@ -304,7 +429,6 @@ void VST2Loader::getEditorSize(int& width, int& height) {
         return;
     }
     
-    struct ERect { short top, left, bottom, right; };
     ERect* rect = nullptr;
     
     effect->dispatcher(effect, effEditGetRect, 0, 0, &rect, 0.0f);
@@ -329,15 +453,13 @@ int VST2Loader::getCurrentProgram() const {
 void VST2Loader::setCurrentProgram(int index) {
     if (effect) {
         effect->dispatcher(effect, effSetProgram, 0, index, nullptr, 0.0f);
+        metadata.invalidateAll();
+        markStateChanged();
     }
 }
 
 juce::String VST2Loader::getProgramName(int index) {
-    if (!effect) return "";
-    
-    char name[256] = {0};
-    effect->dispatcher(effect, effGetProgramName, index, 0, name, 0.0f);
-    return juce::String(name);
+    return metadata.getProgramName(effect, index);
 }
 
 void VST2Loader::setSpeakerArrangement(VstSpeakerArrangement* inputs, VstSpeakerArrangement* outputs) {
@@ -348,6 +470,25 @@ void VST2Loader::setSpeakerArrangement(VstSpeakerArrangement* inputs, VstSpeaker
     }
 }
 
+bool VST2Loader::setSpeakerLayout(const SpeakerLayout& layout) {
+    layout.fillArrangement(inputArrangement);
+    layout.fillArrangement(outputArrangement);
+    
+    if (!effect) return false;
+    
+    // The plugin may write to what it is given - keep ours intact
+    VstSpeakerArrangement inputs = inputArrangement;
+    VstSpeakerArrangement outputs = outputArrangement;
+    VstIntPtr result = effect->dispatcher(effect, effSetSpeakerArrangement, 0, 
+                                         (VstIntPtr)&inputs, &outputs, 0.0f);
+    
+    // Forced regardless of the result, as when the effect was opened
+    effect->numInputs = layout.numChannels;
+    effect->numOutputs = layout.numChannels;
+    
+    return result == 1;
+}
+
 bool VST2Loader::getSpeakerArrangement(VstSpeakerArrangement** inputs, VstSpeakerArrangement** outputs) {
     if (!effect) return false;
     
@@ -360,19 +501,108 @@ bool VST2Loader::getSpeakerArrangement(VstSpeakerArrangement** inputs, VstSpeake
 }
 
 void VST2Loader::setSampleRate(double sampleRate) {
+    hostSampleRate.store(sampleRate, std::memory_order_relaxed);
+    
     if (effect) {
         effect->dispatcher(effect, effSetSampleRate, 0, 0, nullptr, (float)sampleRate);
     }
 }
 
 void VST2Loader::setBlockSize(int blockSize) {
+    hostBlockSize.store(blockSize, std::memory_order_relaxed);
+    
     if (effect) {
         effect->dispatcher(effect, effSetBlockSize, 0, blockSize, nullptr, 0.0f);
     }
 }
 
+void VST2Loader::setTimeInfo(const juce::AudioPlayHead::PositionInfo& position, double sampleRate, int sampleOffset) noexcept {
+    VstTimeInfo info {};
+    info.sampleRate = sampleRate;
+    info.samplePos = (double)position.getTimeInSamples().orFallback(0);
+    
+    if (position.getIsPlaying()) info.flags |= kVstTransportPlaying;
+    if (position.getIsRecording()) info.flags |= kVstTransportRecording;
+    if (position.getIsLooping()) info.flags |= kVstTransportCycleActive;
+    
+    constexpr VstInt32 transportFlags = kVstTransportPlaying | kVstTransportRecording | kVstTransportCycleActive;
+    if ((info.flags ^ lastTransportFlags) & transportFlags) {
+        info.flags |= kVstTransportChanged;
+    }
+    lastTransportFlags = info.flags & transportFlags;
+    
+    if (auto ppq = position.getPpqPosition()) {
+        info.ppqPos = *ppq;
+        info.flags |= kVstPpqPosValid;
+    }
+    if (auto bpm = position.getBpm()) {
+        info.tempo = *bpm;
+        info.flags |= kVstTempoValid;
+    }
+    if (auto barStart = position.getPpqPositionOfLastBarStart()) {
+        info.barStartPos = *barStart;
+        info.flags |= kVstBarsValid;
+    }
+    if (auto loop = position.getLoopPoints()) {
+        info.cycleStartPos = loop->ppqStart;
+        info.cycleEndPos = loop->ppqEnd;
+        info.flags |= kVstCyclePosValid;
+    }
+    if (auto timeSignature = position.getTimeSignature()) {
+        info.timeSigNumerator = timeSignature->numerator;
+        info.timeSigDenominator = timeSignature->denominator;
+        info.flags |= kVstTimeSigValid;
+    }
+    if (auto hostTime = position.getHostTimeNs()) {
+        info.nanoSeconds = (double)*hostTime;
+        info.flags |= kVstNanosValid;
+    }
+    
+    // A later chunk of the host block - the transport has moved on since its start
+    if (sampleOffset > 0 && sampleRate > 0.0) {
+        const double offsetSeconds = sampleOffset / sampleRate;
+        if ((info.flags & kVstNanosValid) != 0) {
+            info.nanoSeconds += offsetSeconds * 1.0e9;
+        }
+        
+        if ((info.flags & kVstTransportPlaying) != 0) {
+            info.samplePos += sampleOffset;
+            if ((info.flags & (kVstPpqPosValid | kVstTempoValid)) == (kVstPpqPosValid | kVstTempoValid)) {
+                info.ppqPos += offsetSeconds * info.tempo / 60.0;
+            }
+        }
+    }
+    
+    const auto version = timeInfoVersion.load(std::memory_order_relaxed);
+    timeInfoVersion.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    timeInfo = info;
+    timeInfoVersion.store(version + 2, std::memory_order_release);
+}
+
+void VST2Loader::readTimeInfo(VstTimeInfo& dest) const noexcept {
+    // Any thread - retries while the audio thread is writing, which takes nanoseconds
+    for (;;) {
+        const auto version = timeInfoVersion.load(std::memory_order_acquire);
+        if ((version & 1) != 0) {
+            continue;
+        }
+        
+        dest = timeInfo;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        
+        if (timeInfoVersion.load(std::memory_order_relaxed) == version) {
+            return;
+        }
+    }
+}
+
 void VST2Loader::suspend() {
     if (effect) {
+        if (processing) {
+            effect->dispatcher(effect, effStopProcess, 0, 0, nullptr, 0.0f);
+            processing = false;
+        }
         effect->dispatcher(effect, effMainsChanged, 0, 0, nullptr, 0.0f);
     }
 }
@@ -380,6 +610,18 @@ void VST2Loader::suspend() {
 void VST2Loader::resume() {
     if (effect) {
         effect->dispatcher(effect, effMainsChanged, 0, 1, nullptr, 0.0f);
+        if (!processing) {
+            effect->dispatcher(effect, effStartProcess, 0, 0, nullptr, 0.0f);
+            processing = true;
+        }
+    }
+}
+
+void VST2Loader::setProcessLevel(VstInt32 level) {
+    processLevel.store(level, std::memory_order_relaxed);
+    
+    if (bridgeClient) {
+        bridgeClient->setProcessLevel(level);
     }
 }
 
@@ -394,5 +636,7 @@ bool VST2Loader::setChunk(void* data, int byteSize, bool isPreset) {
     if (!effect) return false;
     
     VstIntPtr result = effect->dispatcher(effect, effSetChunk, isPreset ? 1 : 0, byteSize, data, 0.0f);
+    metadata.invalidateAll();
+    markStateChanged();
     return result == 1;
 }
\ No newline at end of file
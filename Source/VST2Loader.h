@@ -1,204 +1,13 @@
 #pragma once
 #include <JuceHeader.h>
-#include <Windows.h>
-#include <Psapi.h>
 #include <memory>
-
-// VST2 SDK definitions (minimal subset needed)
-typedef int32_t VstInt32;
-typedef intptr_t VstIntPtr;
-
-#ifndef VSTCALLBACK
-  #ifdef _WIN32
-    #define VSTCALLBACK __cdecl
-  #else
-    #define VSTCALLBACK
-  #endif
-#endif
-
-enum VstAEffectFlags {
-    effFlagsHasEditor = 1 << 0,
-    effFlagsCanReplacing = 1 << 4,
-    effFlagsIsSynth = 1 << 8,
-    effFlagsProgramChunks = 1 << 5
-};
-
-enum VstOpcodes {
-    effOpen = 0,
-    effClose = 1,
-    effSetProgram = 2,
-    effGetProgram = 3,
-    effSetProgramName = 4,
-    effGetProgramName = 5,
-    effGetParamLabel = 6,
-    effGetParamDisplay = 7,
-    effGetParamName = 8,
-    effSetSampleRate = 10,
-    effSetBlockSize = 11,
-    effMainsChanged = 12,
-    effEditGetRect = 13,
-    effEditOpen = 14,
-    effEditClose = 15,
-    effEditIdle = 19,
-    effGetChunk = 23,
-    effSetChunk = 24,
-    effProcessReplacing = 26,
-    effCanBeAutomated = 26,
-    effGetTailSize = 52,
-    effGetParameterProperties = 56,
-    effGetVstVersion = 58,
-    effEditKeyDown = 59,
-    effEditKeyUp = 60,
-    effSetEditKnobMode = 61,
-    effGetMidiProgramName = 62,
-    effGetCurrentMidiProgram = 63,
-    effGetMidiProgramCategory = 64,
-    effHasMidiProgramsChanged = 65,
-    effGetMidiKeyName = 66,
-    effBeginSetProgram = 67,
-    effEndSetProgram = 68,
-    effGetSpeakerArrangement = 69,
-    effSetSpeakerArrangement = 42,
-    effShellGetNextPlugin = 70,
-    effStartProcess = 71,
-    effStopProcess = 72,
-    effSetTotalSampleToProcess = 73,
-    effSetPanLaw = 74,
-    effBeginLoadBank = 75,
-    effBeginLoadProgram = 76,
-    effSetProcessPrecision = 77,
-    effGetNumMidiInputChannels = 78,
-    effGetNumMidiOutputChannels = 79,
-    effCanDo = 51
-};
-
-enum VstHostOpcodes {
-    audioMasterAutomate = 0,
-    audioMasterVersion = 1,
-    audioMasterCurrentId = 2,
-    audioMasterIdle = 3,
-    audioMasterPinConnected = 4,
-    audioMasterWantMidi = 6,
-    audioMasterGetTime = 7,
-    audioMasterProcessEvents = 8,
-    audioMasterSetTime = 9,
-    audioMasterTempoAt = 10,
-    audioMasterGetNumAutomatableParameters = 11,
-    audioMasterGetParameterQuantization = 12,
-    audioMasterIOChanged = 13,
-    audioMasterNeedIdle = 14,
-    audioMasterSizeWindow = 15,
-    audioMasterGetSampleRate = 16,
-    audioMasterGetBlockSize = 17,
-    audioMasterGetInputLatency = 18,
-    audioMasterGetOutputLatency = 19,
-    audioMasterGetPreviousPlug = 20,
-    audioMasterGetNextPlug = 21,
-    audioMasterWillReplaceOrAccumulate = 22,
-    audioMasterGetCurrentProcessLevel = 23,
-    audioMasterGetAutomationState = 24,
-    audioMasterOfflineStart = 25,
-    audioMasterOfflineRead = 26,
-    audioMasterOfflineWrite = 27,
-    audioMasterOfflineGetCurrentPass = 28,
-    audioMasterOfflineGetCurrentMetaPass = 29,
-    audioMasterSetOutputSampleRate = 30,
-    audioMasterGetOutputSpeakerArrangement = 31,
-    audioMasterGetVendorString = 32,
-    audioMasterGetProductString = 33,
-    audioMasterGetVendorVersion = 34,
-    audioMasterVendorSpecific = 35,
-    audioMasterSetIcon = 36,
-    audioMasterCanDo = 37,
-    audioMasterGetLanguage = 38,
-    audioMasterOpenWindow = 39,
-    audioMasterCloseWindow = 40,
-    audioMasterGetDirectory = 41,
-    audioMasterUpdateDisplay = 42,
-    audioMasterBeginEdit = 43,
-    audioMasterEndEdit = 44,
-    audioMasterOpenFileSelector = 45,
-    audioMasterCloseFileSelector = 46,
-    audioMasterEditFile = 47,
-    audioMasterGetChunkFile = 48,
-    audioMasterGetInputSpeakerArrangement = 49,
-    
-    // VST 2.1 extensions
-    audioMasterGetSpeakerArrangement = 69,
-    audioMasterSetSpeakerArrangement = 70,
-    audioMasterSetBlockSizeAndSampleRate = 71,
-    audioMasterSetBypass = 72,
-    audioMasterGetEffectName = 73,
-    audioMasterGetErrorText = 74,
-    audioMasterGetVendorName = 75,
-    audioMasterGetProductName = 76,
-    audioMasterGetMasterVersion = 77,
-    audioMasterSetRealTime = 78,
-    audioMasterGetOutputLatencyPtr = 79,
-    audioMasterGetInputLatencyPtr = 80
-};
-
-struct AEffect;
-
-typedef VstIntPtr (*AudioMasterCallback)(AEffect* effect, VstInt32 opcode, VstInt32 index, 
-                                          VstIntPtr value, void* ptr, float opt);
-
-typedef VstIntPtr (*AEffectDispatcherProc)(AEffect* effect, VstInt32 opcode, VstInt32 index, 
-                                            VstIntPtr value, void* ptr, float opt);
-
-typedef void (*AEffectProcessProc)(AEffect* effect, float** inputs, float** outputs, VstInt32 sampleFrames);
-
-typedef void (*AEffectSetParameterProc)(AEffect* effect, VstInt32 index, float parameter);
-typedef float (*AEffectGetParameterProc)(AEffect* effect, VstInt32 index);
-
-struct AEffect {
-    VstInt32 magic;
-    AEffectDispatcherProc dispatcher;
-    AEffectProcessProc process;
-    AEffectSetParameterProc setParameter;
-    AEffectGetParameterProc getParameter;
-    VstInt32 numPrograms;
-    VstInt32 numParams;
-    VstInt32 numInputs;
-    VstInt32 numOutputs;
-    VstInt32 flags;
-    VstIntPtr resvd1;
-    VstIntPtr resvd2;
-    VstInt32 initialDelay;
-    VstInt32 realQualities;
-    VstInt32 offQualities;
-    float ioRatio;
-    void* object;
-    void* user;
-    VstInt32 uniqueID;
-    VstInt32 version;
-    AEffectProcessProc processReplacing;
-    AEffectProcessProc processDoubleReplacing;
-    char future[56];
-};
-
-// VST2 Speaker Arrangement structures
-struct VstSpeakerProperties {
-    float azimuth;
-    float elevation;
-    float radius;
-    float reserved;
-    char name[64];
-    VstInt32 type;
-    char future[28];
-};
-
-struct VstSpeakerArrangement {
-    VstInt32 type;
-    VstInt32 numChannels;
-    VstSpeakerProperties speakers[8];
-};
-
-// Speaker arrangement types
-enum VstSpeakerArrangementType {
-    kSpeakerArrStereo = 0,
-    kSpeakerArr51 = 5
-};
+#include <atomic>
+#include "VST2Types.h"
+#include "BridgeClient.h"
+#include "VST2EngineCache.h"
+#include "PluginEditQueue.h"
+#include "VST2Metadata.h"
+#include "SpeakerLayout.h"
 
 class VST2Loader {
 public:
@@ -206,19 +15,37 @@ public:
     ~VST2Loader();
     
     bool loadPlugin(const juce::String& path);
+    bool loadFromEntryPoint(VSTPluginMainProc mainEntry);  // Statically linked effect, no module
     void unloadPlugin();
     
     bool isLoaded() const { return effect != nullptr; }
     AEffect* getEffect() { return effect; }
+    const juce::String& getPluginPath() const { return pluginPath; }  // Empty unless loaded from a file
+    
+    // Out-of-process hosting through AltiverbBridgeHost (set before loadPlugin)
+    void setUseBridge(bool shouldUseBridge) { useBridge = shouldUseBridge; }
+    bool isUsingBridge() const { return useBridge; }
+    BridgeClient* getBridgeClient() { return bridgeClient.get(); }
     
     // Process audio
     void processReplacing(float** inputs, float** outputs, int sampleFrames);
+    void processDoubleReplacing(double** inputs, double** outputs, int sampleFrames);
+    
+    // Offline rendering: the level reported to the plugin (kVstProcessLevelOffline while
+    // bouncing, unknown otherwise). Bridged plugins ask the helper, so it is passed on.
+    void setProcessLevel(VstInt32 level);
+    VstInt32 getProcessLevel() const noexcept { return processLevel.load(std::memory_order_relaxed); }
+    
+    // Native 64-bit processing - negotiate while suspended, then call only the matching process
+    bool canProcessDouble() const;
+    bool setProcessPrecision(bool use64Bit);
     
-    // Parameter handling
+    // Parameter handling - names, labels and display texts come from the metadata cache
     void setParameter(int index, float value);
     float getParameter(int index);
     int getNumParameters() const;
     juce::String getParameterName(int index);
+    juce::String getParameterLabel(int index);
     juce::String getParameterText(int index);
     
     // Editor handling
@@ -237,40 +64,91 @@ public:
     void setSpeakerArrangement(VstSpeakerArrangement* inputs, VstSpeakerArrangement* outputs);
     bool getSpeakerArrangement(VstSpeakerArrangement** inputs, VstSpeakerArrangement** outputs);
     
-    // Static access to 5.1 arrangement for callback
-    static const VstSpeakerArrangement& getInputArrangement() { return inputArrangement; }
-    static const VstSpeakerArrangement& getOutputArrangement() { return outputArrangement; }
+    // Negotiate a surround layout and size the effect's I/O to it (while suspended).
+    // Returns whether the plugin accepted the arrangement - the I/O is forced either way.
+    bool setSpeakerLayout(const SpeakerLayout& layout);
     
-    // Initialization
+    const VstSpeakerArrangement& getInputArrangement() const { return inputArrangement; }
+    const VstSpeakerArrangement& getOutputArrangement() const { return outputArrangement; }
+    
+    // Initialization - resume() also starts processing (effStartProcess), suspend() stops it.
+    // The plugin's own audioMasterGetSampleRate/GetBlockSize are answered with these.
     void setSampleRate(double sampleRate);
     void setBlockSize(int blockSize);
+    
+    // Host transport for audioMasterGetTime - audio thread, before each call that
+    // processes audio. sampleOffset is where that call starts within the host block.
+    void setTimeInfo(const juce::AudioPlayHead::PositionInfo& position, double sampleRate, int sampleOffset = 0) noexcept;
     void suspend();
     void resume();
+
     
     // State management
     int getChunk(void** data, bool isPreset);  // Returns byte size or 0 if failed
     bool setChunk(void* data, int byteSize, bool isPreset);
     
+    // Bumped whenever the plugin's state may have changed: automation and display
+    // callbacks, parameter/program/chunk calls, editor open/close and activity.
+    // Lock-free, safe from any thread including the audio thread.
+    void markStateChanged() noexcept { stateChangeCount.fetch_add(1, std::memory_order_acq_rel); }
+    juce::uint32 getStateChangeCount() const noexcept { return stateChangeCount.load(std::memory_order_acquire); }
+    
+    // Bridged plugins call back in the helper process, so their changes can't be seen here
+    bool canTrackStateChanges() const { return !useBridge; }
+    
+    // Edits made in the plugin's own editor, for the owner to forward to the host
+    PluginEditQueue& getEditQueue() { return editQueue; }
+    
     static VstIntPtr VSTCALLBACK hostCallback(AEffect* effect, VstInt32 opcode, VstInt32 index, 
                                               VstIntPtr value, void* ptr, float opt);
     
 private:
-    HMODULE pluginModule = nullptr;
+    // Shared module cache and warm effect pool
+    juce::SharedResourcePointer<VST2EngineCache> engineCache;
+    VST2EngineCache::ModulePtr module;
     AEffect* effect = nullptr;
-    void* editorWindow = nullptr;
+    juce::String pluginPath;
     
-    // Store current speaker arrangements  
-    static VstSpeakerArrangement inputArrangement;
-    static VstSpeakerArrangement outputArrangement;
+    bool useBridge = false;
+    std::unique_ptr<BridgeClient> bridgeClient;
+    void* editorWindow = nullptr;
+    bool processing = false;  // Between effStartProcess and effStopProcess
+    std::atomic<VstInt32> processLevel { kVstProcessLevelUnknown };
+    std::atomic<double> hostSampleRate { 0.0 };
+    std::atomic<int> hostBlockSize { 0 };
+    
+    // Seqlock: the version is odd while setTimeInfo writes. audioMasterGetTime
+    // copies the struct until it reads the same even version on both sides, and
+    // hands the plugin a copy of its own however long it takes to read it.
+    VstTimeInfo timeInfo {};
+    std::atomic<juce::uint32> timeInfoVersion { 0 };
+    VstInt32 lastTransportFlags = 0;  // Audio thread
+    void readTimeInfo(VstTimeInfo& dest) const noexcept;
+    
+    std::atomic<juce::uint32> stateChangeCount { 0 };
+    PluginEditQueue editQueue;
+    VST2Metadata metadata;
+    
+    // Current speaker arrangements, handed to the plugin when it asks
+    VstSpeakerArrangement inputArrangement {};
+    VstSpeakerArrangement outputArrangement {};
     
     // Store whether plugin wants surround
     bool wantsSurround = false;
     
-    // Original host callback (if we need to chain)
-    static AudioMasterCallback originalHostCallback;
+    // Instantiate, open and negotiate 5.1 with a plugin entry point (also used by the pool thread).
+    // The owner renegotiates its own layout with setSpeakerLayout.
+    static AEffect* openEffect(VSTPluginMainProc mainEntry);
+    
+    // The loader that owns an effect, for plugin callbacks. Attached effects carry it
+    // in resvd1, so the lookup is one load on any thread. Before that, callbacks made
+    // while a loader opens an effect on its own thread resolve to that loader; pooled
+    // effects have none and are answered with defaults.
+    void attachToEffect();
+    static VST2Loader* fromEffect(AEffect* effect);
     
-    // Setup 5.1 speaker arrangement
-    void setup51Arrangement(VstSpeakerArrangement& arrangement);
+    // Copy an arrangement into one the plugin allocated - SDK-sized, so at most 8 speakers
+    static void copyArrangementForPlugin(const VstSpeakerArrangement& arrangement, void* destination);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VST2Loader)
 };
\ No newline at end of file
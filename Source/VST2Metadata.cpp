@@ -0,0 +1,125 @@
+#include "VST2Metadata.h"
+
+void VST2Metadata::build(AEffect* effect) {
+    const juce::ScopedLock sl(lock);
+
+    numParameters = effect ? juce::jmax(0, (int)effect->numParams) : 0;
+    numPrograms = effect ? juce::jmax(0, (int)effect->numPrograms) : 0;
+
+    const size_t numRecords = (size_t)(numParameters * numParameterColumns + numPrograms);
+    table.calloc(juce::jmax((size_t)1, numRecords * recordSize));
+
+    for (auto& word : staleTexts) {
+        word.store(0, std::memory_order_relaxed);
+    }
+    programNamesStale.store(false, std::memory_order_relaxed);
+
+    for (int i = 0; i < numParameters; ++i) {
+        readString(effect, effGetParamName, i, getParameterRecord(i, nameColumn));
+        readString(effect, effGetParamLabel, i, getParameterRecord(i, labelColumn));
+        readString(effect, effGetParamDisplay, i, getParameterRecord(i, textColumn));
+    }
+
+    for (int i = 0; i < numPrograms; ++i) {
+        readProgramName(effect, i);
+    }
+}
+
+void VST2Metadata::clear() {
+    const juce::ScopedLock sl(lock);
+    numParameters = 0;
+    numPrograms = 0;
+    table.free();
+}
+
+juce::String VST2Metadata::getParameterName(int index) const {
+    const juce::ScopedLock sl(lock);
+    return juce::isPositiveAndBelow(index, numParameters) ? juce::String(getParameterRecord(index, nameColumn)) : juce::String();
+}
+
+juce::String VST2Metadata::getParameterLabel(int index) const {
+    const juce::ScopedLock sl(lock);
+    return juce::isPositiveAndBelow(index, numParameters) ? juce::String(getParameterRecord(index, labelColumn)) : juce::String();
+}
+
+juce::String VST2Metadata::getParameterText(AEffect* effect, int index) {
+    const juce::ScopedLock sl(lock);
+
+    if (!juce::isPositiveAndBelow(index, numParameters)) {
+        return {};
+    }
+
+    // Clear the bit before reading, so a change during the read marks it stale again
+    const juce::uint64 bit = (juce::uint64)1 << (index % 64);
+    const bool stale = index >= maxTrackedTexts
+                    || (staleTexts[index / 64].fetch_and(~bit, std::memory_order_acq_rel) & bit) != 0;
+    if (effect && stale) {
+        readString(effect, effGetParamDisplay, index, getParameterRecord(index, textColumn));
+    }
+
+    return juce::String(getParameterRecord(index, textColumn));
+}
+
+juce::String VST2Metadata::getProgramName(AEffect* effect, int index) {
+    const juce::ScopedLock sl(lock);
+
+    if (!juce::isPositiveAndBelow(index, numPrograms)) {
+        return {};
+    }
+
+    if (effect && programNamesStale.exchange(false, std::memory_order_acq_rel)) {
+        for (int i = 0; i < numPrograms; ++i) {
+            readProgramName(effect, i);
+        }
+    }
+
+    return juce::String(getProgramRecord(index));
+}
+
+void VST2Metadata::invalidateParameterText(int index) noexcept {
+    if (juce::isPositiveAndBelow(index, maxTrackedTexts)) {
+        staleTexts[index / 64].fetch_or((juce::uint64)1 << (index % 64), std::memory_order_release);
+    }
+}
+
+void VST2Metadata::invalidateAll() noexcept {
+    for (auto& word : staleTexts) {
+        word.store(~(juce::uint64)0, std::memory_order_release);
+    }
+    programNamesStale.store(true, std::memory_order_release);
+}
+
+char* VST2Metadata::getParameterRecord(int index, Column column) const noexcept {
+    return table.get() + ((size_t)column * (size_t)numParameters + (size_t)index) * recordSize;
+}
+
+char* VST2Metadata::getProgramRecord(int index) const noexcept {
+    return table.get() + ((size_t)(numParameters * numParameterColumns) + (size_t)index) * recordSize;
+}
+
+void VST2Metadata::readString(AEffect* effect, VstInt32 opcode, int index, char* record) {
+    // Plugins routinely overrun the official string limits - give them room
+    char text[256] = {0};
+    effect->dispatcher(effect, opcode, index, 0, text, 0.0f);
+    copyToRecord(text, record);
+}
+
+void VST2Metadata::readProgramName(AEffect* effect, int index) {
+    char text[256] = {0};
+
+    // Indexed lookup doesn't disturb the current program; older plugins only name the current one
+    if (effect->dispatcher(effect, effGetProgramNameIndexed, index, -1, text, 0.0f) == 0) {
+        if (index == (int)effect->dispatcher(effect, effGetProgram, 0, 0, nullptr, 0.0f)) {
+            effect->dispatcher(effect, effGetProgramName, 0, 0, text, 0.0f);
+        } else {
+            snprintf(text, sizeof(text), "Program %d", index + 1);
+        }
+    }
+
+    copyToRecord(text, getProgramRecord(index));
+}
+
+void VST2Metadata::copyToRecord(const char* text, char* record) noexcept {
+    strncpy(record, text, recordSize - 1);
+    record[recordSize - 1] = 0;
+}
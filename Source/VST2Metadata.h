@@ -0,0 +1,59 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include "VST2Types.h"
+
+// Parameter and program strings of a loaded effect, read once after load.
+//
+// Everything lives in one flat table of fixed-size records: parameter
+// names, labels and display texts, then program names. Lookups copy out of
+// the table without dispatching into the plugin. Display texts and program
+// names can change while the plugin runs; invalidating them is lock-free
+// (the audio thread does it on setParameter) and the next lookup re-reads
+// just the stale entries. The stale bits are a fixed array that lives as
+// long as the metadata, so invalidating never races a load or unload;
+// texts of parameters past it are re-read on every lookup.
+class VST2Metadata {
+public:
+    static constexpr int recordSize = 64;  // Bytes per string, including the terminator
+    static constexpr int maxTrackedTexts = 128;
+
+    VST2Metadata() = default;
+
+    // Read everything from a freshly loaded effect, before anyone else uses it
+    void build(AEffect* effect);
+    void clear();
+
+    juce::String getParameterName(int index) const;
+    juce::String getParameterLabel(int index) const;
+
+    // Re-read from the plugin only if invalidated since the last lookup
+    juce::String getParameterText(AEffect* effect, int index);
+    juce::String getProgramName(AEffect* effect, int index);
+
+    // Any thread, lock-free
+    void invalidateParameterText(int index) noexcept;
+    void invalidateAll() noexcept;  // Program change, chunk, audioMasterUpdateDisplay
+
+private:
+    enum Column { nameColumn, labelColumn, textColumn, numParameterColumns };
+
+    juce::CriticalSection lock;          // Guards the table contents and layout
+    juce::HeapBlock<char> table;
+    int numParameters = 0;
+    int numPrograms = 0;
+
+    // One bit per display text, plus one for all program names
+    static constexpr int numStaleWords = maxTrackedTexts / 64;
+    std::atomic<juce::uint64> staleTexts[numStaleWords] {};
+    std::atomic<bool> programNamesStale { false };
+
+    char* getParameterRecord(int index, Column column) const noexcept;
+    char* getProgramRecord(int index) const noexcept;
+
+    static void readString(AEffect* effect, VstInt32 opcode, int index, char* record);
+    void readProgramName(AEffect* effect, int index);
+    static void copyToRecord(const char* text, char* record) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VST2Metadata)
+};
@@ -0,0 +1,290 @@
+#pragma once
+#include <cstdint>
+
+// VST2 SDK definitions (minimal subset needed)
+// Kept free of JUCE so the bridge host and the stand-in effect can share them
+typedef int32_t VstInt32;
+typedef intptr_t VstIntPtr;
+
+#ifndef VSTCALLBACK
+  #ifdef _WIN32
+    #define VSTCALLBACK __cdecl
+  #else
+    #define VSTCALLBACK
+  #endif
+#endif
+
+enum VstAEffectFlags {
+    effFlagsHasEditor = 1 << 0,
+    effFlagsCanReplacing = 1 << 4,
+    effFlagsIsSynth = 1 << 8,
+    effFlagsProgramChunks = 1 << 5,
+    effFlagsCanDoubleReplacing = 1 << 12
+};
+
+// audioMasterGetCurrentProcessLevel answers
+enum VstProcessLevels {
+    kVstProcessLevelUnknown = 0,
+    kVstProcessLevelUser = 1,
+    kVstProcessLevelRealtime = 2,
+    kVstProcessLevelPrefetch = 3,
+    kVstProcessLevelOffline = 4
+};
+
+// effSetProcessPrecision values
+enum VstProcessPrecision {
+    kVstProcessPrecision32 = 0,
+    kVstProcessPrecision64 = 1
+};
+
+// Buffer sizes the SDK guarantees for strings passed to the plugin
+enum VstStringConstants {
+    kVstMaxProgNameLen = 24,
+    kVstMaxParamStrLen = 8
+};
+
+enum VstOpcodes {
+    effOpen = 0,
+    effClose = 1,
+    effSetProgram = 2,
+    effGetProgram = 3,
+    effSetProgramName = 4,
+    effGetProgramName = 5,
+    effGetParamLabel = 6,
+    effGetParamDisplay = 7,
+    effGetParamName = 8,
+    effSetSampleRate = 10,
+    effSetBlockSize = 11,
+    effMainsChanged = 12,
+    effEditGetRect = 13,
+    effEditOpen = 14,
+    effEditClose = 15,
+    effEditIdle = 19,
+    effGetChunk = 23,
+    effSetChunk = 24,
+    effProcessReplacing = 26,
+    effCanBeAutomated = 26,
+    effGetProgramNameIndexed = 29,
+    effGetTailSize = 52,
+    effGetParameterProperties = 56,
+    effGetVstVersion = 58,
+    effEditKeyDown = 59,
+    effEditKeyUp = 60,
+    effSetEditKnobMode = 61,
+    effGetMidiProgramName = 62,
+    effGetCurrentMidiProgram = 63,
+    effGetMidiProgramCategory = 64,
+    effHasMidiProgramsChanged = 65,
+    effGetMidiKeyName = 66,
+    effBeginSetProgram = 67,
+    effEndSetProgram = 68,
+    effGetSpeakerArrangement = 69,
+    effSetSpeakerArrangement = 42,
+    effShellGetNextPlugin = 70,
+    effStartProcess = 71,
+    effStopProcess = 72,
+    effSetTotalSampleToProcess = 73,
+    effSetPanLaw = 74,
+    effBeginLoadBank = 75,
+    effBeginLoadProgram = 76,
+    effSetProcessPrecision = 77,
+    effGetNumMidiInputChannels = 78,
+    effGetNumMidiOutputChannels = 79,
+    effCanDo = 51
+};
+
+enum VstHostOpcodes {
+    audioMasterAutomate = 0,
+    audioMasterVersion = 1,
+    audioMasterCurrentId = 2,
+    audioMasterIdle = 3,
+    audioMasterPinConnected = 4,
+    audioMasterWantMidi = 6,
+    audioMasterGetTime = 7,
+    audioMasterProcessEvents = 8,
+    audioMasterSetTime = 9,
+    audioMasterTempoAt = 10,
+    audioMasterGetNumAutomatableParameters = 11,
+    audioMasterGetParameterQuantization = 12,
+    audioMasterIOChanged = 13,
+    audioMasterNeedIdle = 14,
+    audioMasterSizeWindow = 15,
+    audioMasterGetSampleRate = 16,
+    audioMasterGetBlockSize = 17,
+    audioMasterGetInputLatency = 18,
+    audioMasterGetOutputLatency = 19,
+    audioMasterGetPreviousPlug = 20,
+    audioMasterGetNextPlug = 21,
+    audioMasterWillReplaceOrAccumulate = 22,
+    audioMasterGetCurrentProcessLevel = 23,
+    audioMasterGetAutomationState = 24,
+    audioMasterOfflineStart = 25,
+    audioMasterOfflineRead = 26,
+    audioMasterOfflineWrite = 27,
+    audioMasterOfflineGetCurrentPass = 28,
+    audioMasterOfflineGetCurrentMetaPass = 29,
+    audioMasterSetOutputSampleRate = 30,
+    audioMasterGetOutputSpeakerArrangement = 31,
+    audioMasterGetVendorString = 32,
+    audioMasterGetProductString = 33,
+    audioMasterGetVendorVersion = 34,
+    audioMasterVendorSpecific = 35,
+    audioMasterSetIcon = 36,
+    audioMasterCanDo = 37,
+    audioMasterGetLanguage = 38,
+    audioMasterOpenWindow = 39,
+    audioMasterCloseWindow = 40,
+    audioMasterGetDirectory = 41,
+    audioMasterUpdateDisplay = 42,
+    audioMasterBeginEdit = 43,
+    audioMasterEndEdit = 44,
+    audioMasterOpenFileSelector = 45,
+    audioMasterCloseFileSelector = 46,
+    audioMasterEditFile = 47,
+    audioMasterGetChunkFile = 48,
+    audioMasterGetInputSpeakerArrangement = 49,
+    
+    // VST 2.1 extensions
+    audioMasterGetSpeakerArrangement = 69,
+    audioMasterSetSpeakerArrangement = 70,
+    audioMasterSetBlockSizeAndSampleRate = 71,
+    audioMasterSetBypass = 72,
+    audioMasterGetEffectName = 73,
+    audioMasterGetErrorText = 74,
+    audioMasterGetVendorName = 75,
+    audioMasterGetProductName = 76,
+    audioMasterGetMasterVersion = 77,
+    audioMasterSetRealTime = 78,
+    audioMasterGetOutputLatencyPtr = 79,
+    audioMasterGetInputLatencyPtr = 80
+};
+
+struct AEffect;
+
+typedef VstIntPtr (*AudioMasterCallback)(AEffect* effect, VstInt32 opcode, VstInt32 index, 
+                                          VstIntPtr value, void* ptr, float opt);
+
+typedef VstIntPtr (*AEffectDispatcherProc)(AEffect* effect, VstInt32 opcode, VstInt32 index, 
+                                            VstIntPtr value, void* ptr, float opt);
+
+typedef void (*AEffectProcessProc)(AEffect* effect, float** inputs, float** outputs, VstInt32 sampleFrames);
+typedef void (*AEffectProcessDoubleProc)(AEffect* effect, double** inputs, double** outputs, VstInt32 sampleFrames);
+
+typedef void (*AEffectSetParameterProc)(AEffect* effect, VstInt32 index, float parameter);
+typedef float (*AEffectGetParameterProc)(AEffect* effect, VstInt32 index);
+
+struct AEffect {
+    VstInt32 magic;
+    AEffectDispatcherProc dispatcher;
+    AEffectProcessProc process;
+    AEffectSetParameterProc setParameter;
+    AEffectGetParameterProc getParameter;
+    VstInt32 numPrograms;
+    VstInt32 numParams;
+    VstInt32 numInputs;
+    VstInt32 numOutputs;
+    VstInt32 flags;
+    VstIntPtr resvd1;
+    VstIntPtr resvd2;
+    VstInt32 initialDelay;
+    VstInt32 realQualities;
+    VstInt32 offQualities;
+    float ioRatio;
+    void* object;
+    void* user;
+    VstInt32 uniqueID;
+    VstInt32 version;
+    AEffectProcessProc processReplacing;
+    AEffectProcessDoubleProc processDoubleReplacing;
+    char future[56];
+};
+
+// Editor rectangle returned by effEditGetRect
+struct ERect {
+    short top;
+    short left;
+    short bottom;
+    short right;
+};
+
+// Host transport returned by audioMasterGetTime
+struct VstTimeInfo {
+    double samplePos;
+    double sampleRate;
+    double nanoSeconds;
+    double ppqPos;
+    double tempo;
+    double barStartPos;
+    double cycleStartPos;
+    double cycleEndPos;
+    VstInt32 timeSigNumerator;
+    VstInt32 timeSigDenominator;
+    VstInt32 smpteOffset;
+    VstInt32 smpteFrameRate;
+    VstInt32 samplesToNextClock;
+    VstInt32 flags;
+};
+
+enum VstTimeInfoFlags {
+    kVstTransportChanged = 1,
+    kVstTransportPlaying = 1 << 1,
+    kVstTransportCycleActive = 1 << 2,
+    kVstTransportRecording = 1 << 3,
+    kVstNanosValid = 1 << 8,
+    kVstPpqPosValid = 1 << 9,
+    kVstTempoValid = 1 << 10,
+    kVstBarsValid = 1 << 11,
+    kVstCyclePosValid = 1 << 12,
+    kVstTimeSigValid = 1 << 13
+};
+
+// Plugin entry point (VSTPluginMain / main)
+typedef AEffect* (*VSTPluginMainProc)(AudioMasterCallback);
+
+// VST2 Speaker Arrangement structures
+struct VstSpeakerProperties {
+    float azimuth;
+    float elevation;
+    float radius;
+    float reserved;
+    char name[64];
+    VstInt32 type;
+    char future[28];
+};
+
+// The SDK declares 8 speakers and lets hosts allocate more - room for 7.1.4 here
+constexpr int vstSdkMaxSpeakers = 8;
+constexpr int vstMaxSpeakers = 16;
+
+struct VstSpeakerArrangement {
+    VstInt32 type;
+    VstInt32 numChannels;
+    VstSpeakerProperties speakers[vstMaxSpeakers];
+};
+
+// Speaker arrangement types
+enum VstSpeakerArrangementType {
+    kSpeakerArrUserDefined = -2,
+    kSpeakerArrMono = 0,
+    kSpeakerArrStereo = 1,
+    kSpeakerArrStereoSurround = 2,
+    kSpeakerArrStereoCLfe = 5,
+    kSpeakerArr51 = 15,
+    kSpeakerArr71Music = 23
+};
+
+// Speaker types
+enum VstSpeakerType {
+    kSpeakerL = 1,
+    kSpeakerR = 2,
+    kSpeakerC = 3,
+    kSpeakerLfe = 4,
+    kSpeakerLs = 5,
+    kSpeakerRs = 6,
+    kSpeakerSl = 10,
+    kSpeakerSr = 11,
+    kSpeakerTfl = 13,
+    kSpeakerTfr = 15,
+    kSpeakerTrl = 16,
+    kSpeakerTrr = 18
+};
@@ -0,0 +1,80 @@
+#include "WakeSignal.h"
+
+#if JUCE_WINDOWS
+  #include <Windows.h>
+#elif JUCE_MAC
+  #include <dispatch/dispatch.h>
+#elif JUCE_LINUX
+  #include <climits>
+  #include <ctime>
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+WakeSignal::WakeSignal() {
+    #if JUCE_WINDOWS
+    handle = CreateEventA(nullptr, FALSE, FALSE, nullptr);  // Auto-reset
+    #elif JUCE_MAC
+    handle = dispatch_semaphore_create(0);
+    #endif
+}
+
+WakeSignal::~WakeSignal() {
+    #if JUCE_WINDOWS
+    CloseHandle(handle);
+    #elif JUCE_MAC
+    dispatch_release(static_cast<dispatch_semaphore_t>(handle));
+    #endif
+}
+
+void WakeSignal::notify() noexcept {
+    sequence.fetch_add(1, std::memory_order_seq_cst);
+
+    // Nobody parked - the counter alone tells the next wait() to return
+    if (numWaiting.load(std::memory_order_seq_cst) == 0) {
+        return;
+    }
+
+    #if JUCE_WINDOWS
+    SetEvent(handle);
+    #elif JUCE_MAC
+    dispatch_semaphore_signal(static_cast<dispatch_semaphore_t>(handle));
+    #elif JUCE_LINUX
+    syscall(SYS_futex, reinterpret_cast<juce::uint32*>(&sequence), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    #endif
+}
+
+void WakeSignal::wait(int timeoutMs) noexcept {
+    const auto current = sequence.load(std::memory_order_acquire);
+
+    if (current == seenSequence) {
+        // Announced before the counter is checked again, so a notify() either
+        // sees a waiter or has already moved the counter on
+        numWaiting.fetch_add(1, std::memory_order_seq_cst);
+
+        if (sequence.load(std::memory_order_seq_cst) == current) {
+            #if JUCE_WINDOWS
+            WaitForSingleObject(handle, timeoutMs < 0 ? INFINITE : (DWORD)timeoutMs);
+            #elif JUCE_MAC
+            const auto deadline = timeoutMs < 0 ? DISPATCH_TIME_FOREVER
+                                                : dispatch_time(DISPATCH_TIME_NOW, (int64_t)timeoutMs * 1000000);
+            dispatch_semaphore_wait(static_cast<dispatch_semaphore_t>(handle), deadline);
+            #elif JUCE_LINUX
+            timespec timeout;
+            timeout.tv_sec = timeoutMs / 1000;
+            timeout.tv_nsec = (long)(timeoutMs % 1000) * 1000000L;
+
+            // Returns straight away if the counter has moved since it was read
+            syscall(SYS_futex, reinterpret_cast<juce::uint32*>(&sequence), FUTEX_WAIT_PRIVATE, current,
+                    timeoutMs < 0 ? nullptr : &timeout, nullptr, 0);
+            #else
+            juce::Thread::sleep(1);
+            #endif
+        }
+
+        numWaiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    seenSequence = sequence.load(std::memory_order_acquire);
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+// Wakes a thread parked on it, without a lock on the notifying side.
+//
+// notify() bumps a counter and only calls into the kernel when a thread is
+// actually parked - a futex on Linux, an event on Windows, a dispatch
+// semaphore on macOS - so the audio thread can hand work over every block
+// without taking the mutex a juce::WaitableEvent would. One thread waits.
+class WakeSignal {
+public:
+    WakeSignal();
+    ~WakeSignal();
+
+    // Any thread, real-time safe
+    void notify() noexcept;
+
+    // Waiting thread: returns once notify() has been called since the last
+    // return, or after timeoutMs (-1 = no timeout). Callers recheck their
+    // condition - a return can also be spurious.
+    void wait(int timeoutMs) noexcept;
+
+private:
+    std::atomic<juce::uint32> sequence { 0 };
+    std::atomic<int> numWaiting { 0 };
+    juce::uint32 seenSequence = 0;  // Waiting thread
+
+    #if JUCE_WINDOWS || JUCE_MAC
+    void* handle = nullptr;
+    #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WakeSignal)
+};
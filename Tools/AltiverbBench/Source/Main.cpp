@@ -0,0 +1,608 @@
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "VST2Loader.h"
+#include "PluginProcessor.h"
+#include "EditorIdleScheduler.h"
+#include "RealtimeAudit.h"
+#include "StandInEffect.h"
+
+// AltiverbBench
+//
+// Streams a multichannel WAV through VST2Loader::processReplacing outside of
+// any DAW and reports realtime factor, per-block timing and allocations.
+//
+//   AltiverbBench [--plugin <path>] [--input <file.wav>] [--output <file.wav>]
+//                 [--block-sizes 64,256,1024] [--sample-rate 48000]
+//                 [--seconds 30] [--bridge] [--json <results.json>] [--audit]
+//
+// Without --plugin the built-in stand-in effect is used; without --input
+// the bench generates deterministic noise.
+//
+// --audit needs the Audit configuration (ALTIVERB_RT_AUDIT=1): every
+// allocation, mutex lock and blocking call made inside processReplacing,
+// by the loader or the plugin, is reported per block size with its call
+// site, and the bench exits with 3 if there were any.
+//
+// --processor runs AltiverbSurroundProcessor itself instead of the bare loader:
+// prepareToPlay and processBlock in 5.1, 7.1 and 7.1.4, each in the direct,
+// constant-block FIFO, pipelined, split-engine and bypass modes. The processor
+// loads its engine from a file, so it needs --plugin (the StandInEffect library
+// will do). With --audit this covers the worker, pipeline and bypass paths too.
+//
+// --test-idle-scheduler checks EditorIdleScheduler's cadence against the
+// stand-in effect instead of benchmarking, and exits with 1 on a failure.
+
+//==============================================================================
+// Allocation counting - only calls made while counting is armed are recorded
+
+static std::atomic<bool> countAllocations { false };
+static std::atomic<juce::int64> allocationCount { 0 };
+static std::atomic<juce::int64> allocatedBytes { 0 };
+
+static void* countedAlloc(std::size_t size) {
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add((juce::int64)size, std::memory_order_relaxed);
+    }
+
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+//==============================================================================
+
+namespace {
+
+constexpr int numChannels = 6;
+
+struct RunResult {
+    juce::String configuration;  // Layout and mode, --processor only
+    int blockSize = 0;
+    int numBlocks = 0;
+    double realtimeFactor = 0.0;
+    double meanMicroseconds = 0.0;
+    double p50Microseconds = 0.0;
+    double p99Microseconds = 0.0;
+    double maxMicroseconds = 0.0;
+    juce::int64 allocations = 0;
+    juce::int64 allocatedBytes = 0;
+    RealtimeAudit::Summary audit;
+};
+
+// Source audio: a WAV file read block by block, or generated noise
+class BenchSource {
+public:
+    bool open(const juce::File& file) {
+        formatManager.registerBasicFormats();
+        reader.reset(formatManager.createReaderFor(file));
+        return reader != nullptr;
+    }
+
+    void generate(double sampleRate, double seconds) {
+        generatedSampleRate = sampleRate;
+        generatedLength = (juce::int64)(sampleRate * seconds);
+    }
+
+    double getSampleRate() const { return reader ? reader->sampleRate : generatedSampleRate; }
+    juce::int64 getLengthInSamples() const { return reader ? reader->lengthInSamples : generatedLength; }
+    int getNumChannels() const { return reader ? (int)reader->numChannels : numChannels; }
+
+    void rewind() { random.setSeed(0x41565242); }
+
+    // Fills every destination channel; missing file channels are left silent
+    void read(juce::AudioBuffer<float>& destination, juce::int64 position, int numSamples) {
+        destination.clear();
+
+        if (reader) {
+            fileBuffer.setSize((int)reader->numChannels, numSamples, false, false, true);
+            reader->read(&fileBuffer, 0, numSamples, position, true, true);
+
+            for (int ch = 0; ch < juce::jmin(destination.getNumChannels(), fileBuffer.getNumChannels()); ++ch) {
+                destination.copyFrom(ch, 0, fileBuffer, ch, 0, numSamples);
+            }
+            return;
+        }
+
+        for (int ch = 0; ch < destination.getNumChannels(); ++ch) {
+            float* data = destination.getWritePointer(ch);
+            for (int i = 0; i < numSamples; ++i) {
+                data[i] = (random.nextFloat() * 2.0f - 1.0f) * 0.25f;
+            }
+        }
+    }
+
+private:
+    juce::AudioFormatManager formatManager;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::AudioBuffer<float> fileBuffer;
+    juce::Random random { 0x41565242 };
+    double generatedSampleRate = 48000.0;
+    juce::int64 generatedLength = 0;
+};
+
+// Timing and allocation figures of a finished run - sorts blockTimes
+void summariseBlockTimes(RunResult& run, std::vector<double>& blockTimes, double totalSeconds, double audioSeconds) {
+    run.numBlocks = (int)blockTimes.size();
+    run.allocations = allocationCount.load();
+    run.allocatedBytes = allocatedBytes.load();
+
+    if (!blockTimes.empty()) {
+        run.meanMicroseconds = totalSeconds * 1.0e6 / (double)blockTimes.size();
+        std::sort(blockTimes.begin(), blockTimes.end());
+        run.p50Microseconds = blockTimes[(blockTimes.size() - 1) / 2];
+        run.p99Microseconds = blockTimes[(size_t)(0.99 * (double)(blockTimes.size() - 1))];
+        run.maxMicroseconds = blockTimes.back();
+    }
+
+    if (totalSeconds > 0.0) {
+        run.realtimeFactor = audioSeconds / totalSeconds;
+    }
+}
+
+RunResult runBlockSize(VST2Loader& loader, BenchSource& source, double sampleRate, int blockSize,
+                       juce::AudioFormatWriter* writer) {
+    RunResult run;
+    run.blockSize = blockSize;
+
+    const juce::int64 length = source.getLengthInSamples();
+    const int maxBlocks = (int)((length + blockSize - 1) / blockSize);
+
+    juce::AudioBuffer<float> input(numChannels, blockSize);
+    juce::AudioBuffer<float> output(numChannels, blockSize);
+    std::vector<double> blockTimes;
+    blockTimes.reserve((size_t)maxBlocks);
+
+    float* inputs[numChannels];
+    float* outputs[numChannels];
+    for (int ch = 0; ch < numChannels; ++ch) {
+        inputs[ch] = input.getWritePointer(ch);
+        outputs[ch] = output.getWritePointer(ch);
+    }
+
+    loader.setSampleRate(sampleRate);
+    loader.setBlockSize(blockSize);
+    loader.resume();
+    source.rewind();
+
+    allocationCount.store(0);
+    allocatedBytes.store(0);
+    RealtimeAudit::beginSession();
+
+    double totalSeconds = 0.0;
+
+    for (juce::int64 position = 0; position < length; position += blockSize) {
+        const int numSamples = (int)juce::jmin((juce::int64)blockSize, length - position);
+        source.read(input, position, numSamples);
+
+        countAllocations.store(true, std::memory_order_relaxed);
+        auto startTicks = juce::Time::getHighResolutionTicks();
+
+        {
+            const RealtimeAudit::RealtimeSection realtimeSection;
+            loader.processReplacing(inputs, outputs, numSamples);
+        }
+
+        auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+        countAllocations.store(false, std::memory_order_relaxed);
+
+        double seconds = juce::Time::highResolutionTicksToSeconds(elapsedTicks);
+        totalSeconds += seconds;
+        blockTimes.push_back(seconds * 1.0e6);
+
+        if (writer) {
+            writer->writeFromAudioSampleBuffer(output, 0, numSamples);
+        }
+    }
+
+    loader.suspend();
+
+    run.audit = RealtimeAudit::getSummary();
+    summariseBlockTimes(run, blockTimes, totalSeconds, (double)length / sampleRate);
+    return run;
+}
+
+//==============================================================================
+// AltiverbSurroundProcessor itself, every mode a host can put it in
+
+struct ProcessorMode {
+    const char* name;
+    bool constantBlock;
+    bool pipelined;
+    bool split;
+    bool bypassCycle;  // Engaged, bypassed, engaged again - a third of the run each
+};
+
+constexpr ProcessorMode processorModes[] = {
+    { "direct",    false, false, false, false },
+    { "fifo",      true,  false, false, false },
+    { "pipelined", false, true,  false, false },
+    { "split",     false, false, true,  false },
+    { "bypass",    false, false, false, true  }
+};
+
+// The processor's timer suspends the bypassed engine and re-prepares once split
+// engines have loaded - the bench has no message loop of its own
+void runMessageLoop(int milliseconds) {
+    juce::MessageManager::getInstance()->runDispatchLoopUntil(milliseconds);
+}
+
+RunResult runProcessor(AltiverbSurroundProcessor& processor, const juce::AudioChannelSet& channelSet,
+                       const ProcessorMode& mode, BenchSource& source, double sampleRate, int blockSize) {
+    const SpeakerLayout& layout = *SpeakerLayout::find(channelSet);
+
+    RunResult run;
+    run.configuration = juce::String(layout.name) + " " + mode.name;
+    run.blockSize = blockSize;
+
+    juce::AudioProcessor::BusesLayout buses;
+    buses.inputBuses.add(channelSet);
+    buses.outputBuses.add(channelSet);
+    processor.setBusesLayout(buses);
+    processor.setConstantBlockModeEnabled(mode.constantBlock);
+    processor.setPipelinedModeEnabled(mode.pipelined);
+    processor.setEngineSplitEnabled(mode.split);
+
+    // prepareToPlay starts the audit session
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    // Split engines load in the background and the processor runs unsplit until they are there
+    for (int waited = 0; mode.split && processor.getNumActiveEngines() < layout.numGroups && waited < 5000; waited += 50) {
+        runMessageLoop(50);
+    }
+
+    const juce::int64 length = source.getLengthInSamples();
+    const int maxBlocks = (int)((length + blockSize - 1) / blockSize);
+
+    juce::AudioBuffer<float> buffer(layout.numChannels, blockSize);
+    juce::MidiBuffer midi;
+    std::vector<double> blockTimes;
+    blockTimes.reserve((size_t)maxBlocks);
+
+    source.rewind();
+    allocationCount.store(0);
+    allocatedBytes.store(0);
+
+    double totalSeconds = 0.0;
+    int blockIndex = 0;
+
+    for (juce::int64 position = 0; position < length; position += blockSize, ++blockIndex) {
+        const int numSamples = (int)juce::jmin((juce::int64)blockSize, length - position);
+        source.read(buffer, position, numSamples);
+
+        if (mode.bypassCycle && blockIndex % 16 == 0) {
+            runMessageLoop(1);
+        }
+
+        const bool bypassed = mode.bypassCycle && position >= length / 3 && position < length * 2 / 3;
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), layout.numChannels, numSamples);
+
+        // processBlock opens its own real-time section
+        countAllocations.store(true, std::memory_order_relaxed);
+        auto startTicks = juce::Time::getHighResolutionTicks();
+
+        if (bypassed) {
+            processor.processBlockBypassed(block, midi);
+        } else {
+            processor.processBlock(block, midi);
+        }
+
+        auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+        countAllocations.store(false, std::memory_order_relaxed);
+
+        double seconds = juce::Time::highResolutionTicksToSeconds(elapsedTicks);
+        totalSeconds += seconds;
+        blockTimes.push_back(seconds * 1.0e6);
+    }
+
+    // Before releaseResources, which logs the session and leaves the engine threads idle
+    run.audit = RealtimeAudit::getSummary();
+    processor.releaseResources();
+
+    summariseBlockTimes(run, blockTimes, totalSeconds, (double)length / sampleRate);
+    return run;
+}
+
+juce::var toJson(const RealtimeAudit::Summary& audit) {
+    auto* object = new juce::DynamicObject();
+    for (int kind = 0; kind < RealtimeAudit::numViolationKinds; ++kind) {
+        object->setProperty(RealtimeAudit::getViolationName((RealtimeAudit::Violation)kind), audit.counts[kind]);
+    }
+    object->setProperty("notLogged", audit.dropped);
+
+    juce::Array<juce::var> callSites;
+    for (auto& site : audit.callSites) {
+        callSites.add(site);
+    }
+    object->setProperty("callSites", callSites);
+    return juce::var(object);
+}
+
+juce::var toJson(const RunResult& run, bool includeAudit) {
+    auto* object = new juce::DynamicObject();
+    if (run.configuration.isNotEmpty()) {
+        object->setProperty("configuration", run.configuration);
+    }
+    object->setProperty("blockSize", run.blockSize);
+    object->setProperty("blocks", run.numBlocks);
+    object->setProperty("realtimeFactor", run.realtimeFactor);
+    object->setProperty("meanMicroseconds", run.meanMicroseconds);
+    object->setProperty("p50Microseconds", run.p50Microseconds);
+    object->setProperty("p99Microseconds", run.p99Microseconds);
+    object->setProperty("maxMicroseconds", run.maxMicroseconds);
+    object->setProperty("allocations", run.allocations);
+    object->setProperty("allocatedBytes", run.allocatedBytes);
+    if (includeAudit) {
+        object->setProperty("audit", toJson(run.audit));
+    }
+    return juce::var(object);
+}
+
+//==============================================================================
+// EditorIdleScheduler cadence. The stand-in's editor idle does nothing; its
+// dispatcher is wrapped so idle calls can be made slow on demand.
+
+AEffectDispatcherProc standInDispatcher = nullptr;
+std::atomic<int> idleDelayMilliseconds { 0 };
+
+VstIntPtr slowIdleDispatcher(AEffect* effect, VstInt32 opcode, VstInt32 index, VstIntPtr value, void* ptr, float opt) {
+    if (opcode == effEditIdle && idleDelayMilliseconds.load() > 0) {
+        juce::Thread::sleep(idleDelayMilliseconds.load());
+    }
+    return standInDispatcher(effect, opcode, index, value, ptr, opt);
+}
+
+bool runIdleSchedulerTest() {
+    using WindowState = EditorIdleScheduler::WindowState;
+
+    AEffect* effect = createStandInEffect(nullptr);
+    standInDispatcher = effect->dispatcher;
+    effect->dispatcher = slowIdleDispatcher;
+
+    EditorIdleScheduler scheduler;
+    int numFailures = 0;
+
+    auto check = [&](const juce::String& name, int actual, int expected) {
+        const bool passed = actual == expected;
+        std::cout << (passed ? "PASS  " : "FAIL  ") << name << ": " << actual << " ms"
+                  << (passed ? juce::String() : " (expected " + juce::String(expected) + ")") << std::endl;
+        numFailures += passed ? 0 : 1;
+    };
+
+    // Without an effect there is nothing to idle
+    check("no effect", scheduler.step(WindowState::visible), 0);
+
+    scheduler.start(effect, [] { return WindowState::visible; });
+
+    check("visible", scheduler.step(WindowState::visible), EditorIdleScheduler::displayIntervalMs);
+    check("hidden", scheduler.step(WindowState::hidden), EditorIdleScheduler::backgroundIntervalMs);
+    check("minimised", scheduler.step(WindowState::minimised), EditorIdleScheduler::backgroundIntervalMs);
+
+    const int idleCallsBeforeClose = scheduler.getNumIdleCalls();
+    check("closed", scheduler.step(WindowState::closed), 0);
+    check("closed sends no idle", scheduler.getNumIdleCalls() - idleCallsBeforeClose, 0);
+
+    // Slow idle calls stretch the visible interval, capped at the maximum
+    idleDelayMilliseconds.store(10);
+    int slowInterval = 0;
+    for (int i = 0; i < 20; ++i) {
+        slowInterval = scheduler.step(WindowState::visible);
+    }
+    const bool backedOff = slowInterval > EditorIdleScheduler::displayIntervalMs
+                        && slowInterval <= EditorIdleScheduler::maxIntervalMs;
+    std::cout << (backedOff ? "PASS  " : "FAIL  ") << "slow idle backs off: " << slowInterval << " ms after "
+              << juce::String(scheduler.getIdleCostMilliseconds(), 1) << " ms idle calls" << std::endl;
+    numFailures += backedOff ? 0 : 1;
+
+    check("slow idle while hidden", scheduler.step(WindowState::hidden), EditorIdleScheduler::backgroundIntervalMs);
+
+    // And recover once the editor is fast again
+    idleDelayMilliseconds.store(0);
+    int fastInterval = 0;
+    for (int i = 0; i < 40; ++i) {
+        fastInterval = scheduler.step(WindowState::visible);
+    }
+    check("recovers", fastInterval, EditorIdleScheduler::displayIntervalMs);
+
+    scheduler.stop();
+    effect->dispatcher = standInDispatcher;
+    effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
+
+    std::cout << std::endl << (numFailures == 0 ? "All idle scheduler checks passed"
+                                                : juce::String(numFailures) + " idle scheduler checks failed") << std::endl;
+    return numFailures == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i) {
+        args.add(juce::String::fromUTF8(argv[i]));
+    }
+
+    auto getOption = [&](const juce::String& name, const juce::String& fallback) {
+        int index = args.indexOf(name);
+        return (index >= 0 && index + 1 < args.size()) ? args[index + 1] : fallback;
+    };
+
+    if (args.contains("--help")) {
+        std::cout << "Usage: AltiverbBench [--plugin <path>] [--input <file.wav>] [--output <file.wav>]" << std::endl;
+        std::cout << "                     [--block-sizes 64,256,1024] [--sample-rate 48000]" << std::endl;
+        std::cout << "                     [--seconds 30] [--bridge] [--json <results.json>] [--audit]" << std::endl;
+        std::cout << "       AltiverbBench --processor --plugin <path> [--block-sizes 256] [--audit] ..." << std::endl;
+        std::cout << "       AltiverbBench --test-idle-scheduler" << std::endl;
+        return 0;
+    }
+
+    if (args.contains("--test-idle-scheduler")) {
+        return runIdleSchedulerTest() ? 0 : 1;
+    }
+
+    const juce::String pluginPath = getOption("--plugin", {});
+    const juce::String inputPath = getOption("--input", {});
+    const juce::String outputPath = getOption("--output", {});
+    const juce::String jsonPath = getOption("--json", {});
+    const bool audit = args.contains("--audit");
+    const bool processorMode = args.contains("--processor");
+
+    if (audit && !RealtimeAudit::enabled) {
+        std::cerr << "--audit needs a build with ALTIVERB_RT_AUDIT=1 (the Audit configuration)" << std::endl;
+        return 2;
+    }
+
+    if (processorMode && pluginPath.isEmpty()) {
+        std::cerr << "--processor needs --plugin - the processor loads its engine from a file" << std::endl;
+        return 2;
+    }
+
+    // Load the engine - into the processor, or a bare loader
+    std::unique_ptr<AltiverbSurroundProcessor> processor;
+    VST2Loader loader;
+    bool loaded = false;
+
+    if (processorMode) {
+        processor = std::make_unique<AltiverbSurroundProcessor>();
+        processor->getVST2Loader()->setUseBridge(args.contains("--bridge"));
+        loaded = processor->loadEngineAndWait(pluginPath);
+    } else {
+        loader.setUseBridge(args.contains("--bridge"));
+        loaded = pluginPath.isNotEmpty() ? loader.loadPlugin(pluginPath)
+                                         : loader.loadFromEntryPoint(createStandInEffect);
+    }
+
+    if (!loaded) {
+        std::cerr << "Failed to load " << (pluginPath.isNotEmpty() ? pluginPath : juce::String("stand-in effect")) << std::endl;
+        return 2;
+    }
+
+    // Open the source
+    BenchSource source;
+    if (inputPath.isNotEmpty()) {
+        if (!source.open(juce::File::getCurrentWorkingDirectory().getChildFile(inputPath))) {
+            std::cerr << "Failed to read " << inputPath << std::endl;
+            return 2;
+        }
+    } else {
+        source.generate(getOption("--sample-rate", "48000").getDoubleValue(),
+                        getOption("--seconds", "30").getDoubleValue());
+    }
+
+    const double sampleRate = args.contains("--sample-rate") ? getOption("--sample-rate", {}).getDoubleValue()
+                                                             : source.getSampleRate();
+
+    juce::Array<int> blockSizes;
+    // Fifteen configurations per block size with --processor, so one size by default
+    const juce::String defaultBlockSizes = processorMode ? "256" : "64,128,256,512,1024";
+    for (auto& token : juce::StringArray::fromTokens(getOption("--block-sizes", defaultBlockSizes), ",", "")) {
+        int blockSize = token.trim().getIntValue();
+        if (blockSize > 0) {
+            blockSizes.add(blockSize);
+        }
+    }
+
+    const bool bridged = processorMode ? processor->getVST2Loader()->isUsingBridge() : loader.isUsingBridge();
+
+    std::cout << "Engine:      " << (pluginPath.isNotEmpty() ? pluginPath : juce::String("stand-in effect"))
+              << (bridged ? " (bridged)" : "") << (processorMode ? ", in the processor" : "") << std::endl;
+    std::cout << "Source:      " << (inputPath.isNotEmpty() ? inputPath : juce::String("generated noise"))
+              << ", " << source.getNumChannels() << " ch, "
+              << (double)source.getLengthInSamples() / source.getSampleRate() << " s" << std::endl;
+    std::cout << "Sample rate: " << sampleRate << " Hz" << std::endl << std::endl;
+    std::cout << (processorMode ? "configuration     " : "")
+              << "block      RTF      mean us     p50 us     p99 us     max us   allocs" << std::endl;
+
+    juce::Array<juce::var> runs;
+    juce::StringArray auditReports;
+    juce::int64 numViolations = 0;
+
+    auto report = [&](const RunResult& run) {
+        runs.add(toJson(run, audit));
+
+        if (audit) {
+            auditReports.add((run.configuration.isNotEmpty() ? run.configuration + ", block size " : juce::String("Block size "))
+                             + juce::String(run.blockSize) + ": " + run.audit.toString());
+            numViolations += run.audit.getTotal();
+        }
+
+        std::cout << (run.configuration.isNotEmpty() ? run.configuration.paddedRight(' ', 18) : juce::String())
+                  << juce::String(run.blockSize).paddedLeft(' ', 5)
+                  << juce::String(run.realtimeFactor, 1).paddedLeft(' ', 9)
+                  << juce::String(run.meanMicroseconds, 1).paddedLeft(' ', 13)
+                  << juce::String(run.p50Microseconds, 1).paddedLeft(' ', 11)
+                  << juce::String(run.p99Microseconds, 1).paddedLeft(' ', 11)
+                  << juce::String(run.maxMicroseconds, 1).paddedLeft(' ', 11)
+                  << juce::String(run.allocations).paddedLeft(' ', 9) << std::endl;
+    };
+
+    if (processorMode) {
+        const juce::AudioChannelSet channelSets[] = { juce::AudioChannelSet::create5point1(),
+                                                      juce::AudioChannelSet::create7point1(),
+                                                      juce::AudioChannelSet::create7point1point4() };
+
+        for (int blockSize : blockSizes) {
+            for (auto& channelSet : channelSets) {
+                for (auto& mode : processorModes) {
+                    report(runProcessor(*processor, channelSet, mode, source, sampleRate, blockSize));
+                }
+            }
+        }
+    } else {
+        // Only the bare loader's runs go to --output
+        for (int blockSize : blockSizes) {
+            // Only the last block size is written, so the output file is a single pass
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+            if (outputPath.isNotEmpty() && blockSize == blockSizes.getLast()) {
+                juce::File outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(outputPath);
+                outputFile.deleteFile();
+
+                if (auto stream = outputFile.createOutputStream()) {
+                    juce::WavAudioFormat wav;
+                    writer.reset(wav.createWriterFor(stream.release(), sampleRate, numChannels, 24, {}, 0));
+                }
+            }
+
+            report(runBlockSize(loader, source, sampleRate, blockSize, writer.get()));
+        }
+    }
+
+    // Printed after the table so it stays readable
+    for (auto& report : auditReports) {
+        std::cout << std::endl << report;
+    }
+
+    if (jsonPath.isNotEmpty()) {
+        auto* results = new juce::DynamicObject();
+        results->setProperty("engine", pluginPath.isNotEmpty() ? pluginPath : juce::String("stand-in"));
+        results->setProperty("bridged", bridged);
+        results->setProperty("processor", processorMode);
+        results->setProperty("input", inputPath.isNotEmpty() ? inputPath : juce::String("noise"));
+        results->setProperty("sampleRate", sampleRate);
+        results->setProperty("lengthSamples", source.getLengthInSamples());
+        results->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+        results->setProperty("runs", runs);
+
+        juce::File jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(jsonPath);
+        if (!jsonFile.replaceWithText(juce::JSON::toString(juce::var(results)))) {
+            std::cerr << "Failed to write " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+
+    processor.reset();
+    loader.unloadPlugin();
+    return numViolations > 0 ? 3 : 0;
+}
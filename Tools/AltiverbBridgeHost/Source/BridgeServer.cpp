@@ -0,0 +1,354 @@
+#include "BridgeServer.h"
+
+#if JUCE_WINDOWS
+  #include <Windows.h>
+#else
+  #include <csignal>
+  #include <cerrno>
+#endif
+
+using namespace BridgeProtocol;
+
+// Lanes wake up at least this often to notice shutdown
+static constexpr int pollIntervalMs = 200;
+
+//==============================================================================
+// BridgedEngine
+
+BridgedEngine::LaneThread::LaneThread(BridgedEngine& owner, bool isAudioLane)
+    : juce::Thread(isAudioLane ? "Bridge Audio" : "Bridge Control"),
+      engine(owner),
+      audio(isAudioLane)
+{
+}
+
+void BridgedEngine::LaneThread::run() {
+    BridgeLaneEndpoint& lane = audio ? engine.audioLane : engine.controlLane;
+
+    while (!threadShouldExit()) {
+        Message message;
+
+        if (!lane.waitForRequest(message, pollIntervalMs)) {
+            continue;
+        }
+
+        if (audio) {
+            engine.handleAudio(message);
+        } else {
+            engine.handleControl(message);
+        }
+    }
+}
+
+BridgedEngine::BridgedEngine(const juce::String& channelName)
+    : name(channelName)
+{
+}
+
+BridgedEngine::~BridgedEngine() {
+    if (audioThread) {
+        audioThread->signalThreadShouldExit();
+        audioLane.wakeServer();
+        audioThread->stopThread(2000);
+    }
+
+    if (controlThread) {
+        controlThread->signalThreadShouldExit();
+        controlLane.wakeServer();
+        controlThread->stopThread(2000);
+    }
+
+    loader.unloadPlugin();
+
+    if (header) {
+        header->serverState.store(serverClosed);
+    }
+
+    audioLane.close();
+    controlLane.close();
+    channel.close();
+}
+
+bool BridgedEngine::load(const juce::String& pluginPath) {
+    if (!channel.open(name, channelSegmentSize)) {
+        return false;
+    }
+
+    header = static_cast<ChannelHeader*>(channel.getData());
+    if (header->magic != magic || header->version != version) {
+        return false;
+    }
+
+    if (!audioLane.open(&header->audioLane, name + "_audio")
+        || !controlLane.open(&header->controlLane, name + "_control")) {
+        return false;
+    }
+
+    if (!loader.loadPlugin(pluginPath)) {
+        header->serverState.store(serverFailed);
+        return false;
+    }
+
+    // Publish the effect description for the client's proxy
+    AEffect* effect = loader.getEffect();
+    EffectInfo& info = header->effectInfo;
+    info.numPrograms = effect->numPrograms;
+    info.numParams = effect->numParams;
+    info.numInputs = effect->numInputs;
+    info.numOutputs = effect->numOutputs;
+    info.flags = effect->flags;
+    info.initialDelay = effect->initialDelay;
+    info.uniqueID = effect->uniqueID;
+    info.version = effect->version;
+
+    audioThread = std::make_unique<LaneThread>(*this, true);
+    controlThread = std::make_unique<LaneThread>(*this, false);
+
+    audioThread->startRealtimeThread(juce::Thread::RealtimeOptions().withPriority(10));
+    controlThread->startThread();
+
+    header->serverState.store(serverReady);
+    return true;
+}
+
+void BridgedEngine::handleAudio(Message& message) {
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    if (message.opcode == bridgeProcess) {
+        // Parameter changes queued since the last block land on its boundary, in order
+        drainParameterRing();
+
+        AEffect* effect = loader.getEffect();
+        const int slot = juce::jlimit(0, audioSlots - 1, (int)message.index);
+        const int numSamples = juce::jlimit(0, maxBlockSize, (int)message.value);
+        const int numInputs = juce::jlimit(0, maxChannels, (int)effect->numInputs);
+        const int numOutputs = juce::jlimit(0, maxChannels, (int)effect->numOutputs);
+
+        float* inputs[maxChannels] = {};
+        float* outputs[maxChannels] = {};
+        for (int ch = 0; ch < maxChannels; ++ch) {
+            inputs[ch] = getAudioChannel(header, slot, false, ch);
+            outputs[ch] = getAudioChannel(header, slot, true, ch);
+        }
+
+        juce::ignoreUnused(numInputs, numOutputs);
+        loader.processReplacing(inputs, outputs, numSamples);
+    }
+
+    auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+    message.serverMicroseconds = juce::Time::highResolutionTicksToSeconds(elapsedTicks) * 1.0e6;
+    audioLane.respond(message);
+}
+
+void BridgedEngine::drainParameterRing() {
+    // Audio lane thread only - the ring's single consumer
+    Message message;
+    while (header->parameterRing.pop(message)) {
+        loader.setParameter(message.index, message.opt);
+    }
+}
+
+void BridgedEngine::handleControl(Message& message) {
+    switch (message.opcode) {
+        case bridgeSetParameter:
+            loader.setParameter(message.index, message.opt);
+            message.result = 1;
+            break;
+
+        case bridgeGetParameter:
+            message.opt = loader.getParameter(message.index);
+            message.result = 1;
+            break;
+
+        case bridgeSetProcessLevel:
+            loader.setProcessLevel((VstInt32)message.value);
+            message.result = 1;
+            break;
+
+        default:
+            message.result = dispatchWithPayload(message);
+            break;
+    }
+
+    controlLane.respond(message);
+}
+
+juce::int64 BridgedEngine::dispatchWithPayload(Message& message) {
+    AEffect* effect = loader.getEffect();
+    char* payload = getPayload(header);
+    const size_t arrangementSize = sizeof(VstSpeakerArrangement);
+
+    const int32_t requestPayloadSize = message.payloadSize;
+    message.payloadSize = 0;
+
+    auto call = [&](VstIntPtr value, void* ptr) {
+        return (juce::int64)effect->dispatcher(effect, message.opcode, message.index, value, ptr, message.opt);
+    };
+
+    switch (getPointerKind(message.opcode)) {
+        case PointerKind::stringOut: {
+            char text[maxStringLength] = {0};
+            juce::int64 result = call((VstIntPtr)message.value, text);
+            text[maxStringLength - 1] = 0;
+            size_t length = strlen(text) + 1;
+            std::memcpy(payload, text, length);
+            message.payloadSize = (int32_t)length;
+            return result;
+        }
+
+        case PointerKind::stringIn:
+            if (requestPayloadSize <= 0) return 0;
+            payload[requestPayloadSize - 1] = 0;
+            return call((VstIntPtr)message.value, payload);
+
+        case PointerKind::chunkOut: {
+            void* data = nullptr;
+            juce::int64 size = call((VstIntPtr)message.value, &data);
+            if (size <= 0 || data == nullptr || (size_t)size > payloadCapacity) {
+                return 0;
+            }
+            std::memcpy(payload, data, (size_t)size);
+            message.payloadSize = (int32_t)size;
+            return size;
+        }
+
+        case PointerKind::chunkIn: {
+            // Give the plugin its own copy - the payload area is reused by the next call
+            juce::MemoryBlock chunk(payload, (size_t)juce::jmax(0, (int)requestPayloadSize));
+            return call((VstIntPtr)chunk.getSize(), chunk.getData());
+        }
+
+        case PointerKind::speakerArrangements: {
+            if (requestPayloadSize != (int32_t)(2 * arrangementSize)) return 0;
+            VstSpeakerArrangement inputs, outputs;
+            std::memcpy(&inputs, payload, arrangementSize);
+            std::memcpy(&outputs, payload + arrangementSize, arrangementSize);
+            juce::int64 result = call((VstIntPtr)&inputs, &outputs);
+            
+            // Mirror the wrapper, which sizes its proxy to the layout whatever the plugin answers
+            if (message.opcode == effSetSpeakerArrangement) {
+                effect->numInputs = juce::jlimit(0, maxChannels, (int)inputs.numChannels);
+                effect->numOutputs = juce::jlimit(0, maxChannels, (int)outputs.numChannels);
+            }
+            
+            std::memcpy(payload, &inputs, arrangementSize);
+            std::memcpy(payload + arrangementSize, &outputs, arrangementSize);
+            message.payloadSize = (int32_t)(2 * arrangementSize);
+            return result;
+        }
+
+        case PointerKind::editorRectOut: {
+            ERect* rect = nullptr;
+            juce::int64 result = call((VstIntPtr)message.value, &rect);
+            if (rect) {
+                std::memcpy(payload, rect, sizeof(ERect));
+                message.payloadSize = (int32_t)sizeof(ERect);
+            }
+            return result;
+        }
+
+        case PointerKind::windowHandle:
+            return call(0, reinterpret_cast<void*>((intptr_t)message.value));
+
+        case PointerKind::none:
+        default:
+            return call((VstIntPtr)message.value, nullptr);
+    }
+}
+
+//==============================================================================
+// BridgeServer
+
+bool BridgeServer::isProcessAlive(int processId) {
+    #if JUCE_WINDOWS
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)processId);
+    if (!process) {
+        return false;
+    }
+    bool running = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return running;
+    #else
+    return kill((pid_t)processId, 0) == 0 || errno == EPERM;
+    #endif
+}
+
+bool BridgeServer::handleRequest(Message& message) {
+    char* payload = static_cast<char*>(session.getData()) + sessionPayloadOffset;
+    payload[sessionPayloadCapacity - 1] = 0;
+    juce::String text = juce::String::fromUTF8(payload);
+
+    switch (message.opcode) {
+        case bridgeAttach: {
+            juce::String channelName = text.upToFirstOccurrenceOf("\n", false, false);
+            juce::String pluginPath = text.fromFirstOccurrenceOf("\n", false, false);
+
+            auto engine = std::make_unique<BridgedEngine>(channelName);
+            message.result = engine->load(pluginPath) ? 1 : 0;
+
+            if (message.result == 1) {
+                engines.push_back(std::move(engine));
+            }
+            break;
+        }
+
+        case bridgeDetach:
+            engines.erase(std::remove_if(engines.begin(), engines.end(),
+                                         [&](const std::unique_ptr<BridgedEngine>& engine) {
+                                             return engine->getChannelName() == text;
+                                         }),
+                          engines.end());
+            message.result = 1;
+            break;
+
+        case bridgeShutdown:
+            engines.clear();
+            message.result = 1;
+            lane.respond(message);
+            return false;
+
+        default:
+            message.result = 0;
+            break;
+    }
+
+    lane.respond(message);
+    return true;
+}
+
+int BridgeServer::run(const juce::String& sessionName, int parentProcessId) {
+    if (!session.open(sessionName, sessionSegmentSize)) {
+        return 1;
+    }
+
+    header = static_cast<SessionHeader*>(session.getData());
+    if (header->magic != magic || header->version != version) {
+        return 1;
+    }
+
+    if (!lane.open(&header->lane, sessionName)) {
+        header->serverState.store(serverFailed);
+        return 1;
+    }
+
+    header->serverState.store(serverReady);
+
+    // Serve until told to stop, or until the DAW is gone
+    for (;;) {
+        Message message;
+
+        if (lane.waitForRequest(message, pollIntervalMs)) {
+            if (!handleRequest(message)) {
+                break;
+            }
+        } else if (parentProcessId > 0 && !isProcessAlive(parentProcessId)) {
+            break;
+        }
+    }
+
+    engines.clear();
+    header->serverState.store(serverClosed);
+    lane.close();
+    session.close();
+    return 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <JuceHeader.h>
+#include "BridgeIPC.h"
+#include "VST2Loader.h"
+
+// Helper side of one bridged plugin: owns the real AEffect and serves the
+// channel's audio and control lanes from two threads, mirroring how a DAW
+// drives a VST2 plugin from its audio and UI threads.
+class BridgedEngine {
+public:
+    BridgedEngine(const juce::String& channelName);
+    ~BridgedEngine();
+
+    bool load(const juce::String& pluginPath);
+    const juce::String& getChannelName() const noexcept { return name; }
+
+private:
+    class LaneThread : public juce::Thread {
+    public:
+        LaneThread(BridgedEngine& owner, bool isAudioLane);
+        void run() override;
+
+    private:
+        BridgedEngine& engine;
+        bool audio;
+    };
+
+    juce::String name;
+    SharedMemoryRegion channel;
+    BridgeProtocol::ChannelHeader* header = nullptr;
+    BridgeLaneEndpoint audioLane;
+    BridgeLaneEndpoint controlLane;
+    VST2Loader loader;
+
+    std::unique_ptr<LaneThread> audioThread;
+    std::unique_ptr<LaneThread> controlThread;
+
+    void handleAudio(BridgeProtocol::Message& message);
+    void handleControl(BridgeProtocol::Message& message);
+    void drainParameterRing();
+    juce::int64 dispatchWithPayload(BridgeProtocol::Message& message);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BridgedEngine)
+};
+
+// Serves the helper-wide session segment: attach/detach requests from every
+// wrapper instance in the parent DAW process.
+class BridgeServer {
+public:
+    BridgeServer() = default;
+
+    // Runs until the parent exits or a shutdown request arrives
+    int run(const juce::String& sessionName, int parentProcessId);
+
+private:
+    SharedMemoryRegion session;
+    BridgeProtocol::SessionHeader* header = nullptr;
+    BridgeLaneEndpoint lane;
+    std::vector<std::unique_ptr<BridgedEngine>> engines;
+
+    bool handleRequest(BridgeProtocol::Message& message);
+    static bool isProcessAlive(int processId);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BridgeServer)
+};
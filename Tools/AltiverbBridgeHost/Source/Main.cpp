@@ -0,0 +1,146 @@
+#include <JuceHeader.h>
+#include "BridgeServer.h"
+#include "BridgeClient.h"
+#include "VST2Loader.h"
+
+// AltiverbBridgeHost
+//
+//   --session <name> --parent <pid>
+//       Serve plugin instances for a wrapper process (launched by BridgeClient).
+//
+//   --self-test <plugin> [--blocks N] [--block-size B]
+//       Run the plugin in-process and through the bridge side by side, check
+//       that both produce identical output and report the bridge overhead.
+
+static int runSelfTest(const juce::String& pluginPath, int numBlocks, int blockSize) {
+    constexpr int numChannels = 6;
+    blockSize = juce::jlimit(16, 8192, blockSize);
+
+    // The bridged instance is served by this same executable
+    BridgeClient::setHelperExecutable(juce::File::getSpecialLocation(juce::File::currentExecutableFile));
+
+    VST2Loader local;
+    VST2Loader bridged;
+    bridged.setUseBridge(true);
+
+    if (!local.loadPlugin(pluginPath)) {
+        std::cerr << "Failed to load " << pluginPath << " in-process" << std::endl;
+        return 2;
+    }
+
+    if (!bridged.loadPlugin(pluginPath)) {
+        std::cerr << "Failed to load " << pluginPath << " through the bridge" << std::endl;
+        return 2;
+    }
+
+    for (auto* loader : { &local, &bridged }) {
+        loader->setSampleRate(48000.0);
+        loader->setBlockSize(blockSize);
+        loader->resume();
+    }
+
+    juce::AudioBuffer<float> input(numChannels, blockSize);
+    juce::AudioBuffer<float> localOutput(numChannels, blockSize);
+    juce::AudioBuffer<float> bridgedOutput(numChannels, blockSize);
+    juce::Random random(0x41565242);
+
+    std::vector<double> overheads;
+    overheads.reserve((size_t)numBlocks);
+    int mismatchedBlocks = 0;
+    float maxDifference = 0.0f;
+
+    BridgeClient* client = bridged.getBridgeClient();
+    client->resetRoundTripStats();
+
+    for (int block = 0; block < numBlocks; ++block) {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            float* data = input.getWritePointer(ch);
+            for (int i = 0; i < blockSize; ++i) {
+                data[i] = random.nextFloat() * 2.0f - 1.0f;
+            }
+        }
+
+        // Both instances must see the same parameter changes
+        if (block % 64 == 0 && local.getNumParameters() > 0) {
+            float value = random.nextFloat();
+            local.setParameter(0, value);
+            bridged.setParameter(0, value);
+        }
+
+        float* inputs[numChannels];
+        for (int ch = 0; ch < numChannels; ++ch) {
+            inputs[ch] = input.getWritePointer(ch);
+        }
+
+        local.processReplacing(inputs, localOutput.getArrayOfWritePointers(), blockSize);
+        bridged.processReplacing(inputs, bridgedOutput.getArrayOfWritePointers(), blockSize);
+        overheads.push_back(client->getRoundTripStats().lastMicroseconds);
+
+        bool matches = true;
+        for (int ch = 0; ch < numChannels; ++ch) {
+            const float* a = localOutput.getReadPointer(ch);
+            const float* b = bridgedOutput.getReadPointer(ch);
+            for (int i = 0; i < blockSize; ++i) {
+                float difference = std::abs(a[i] - b[i]);
+                maxDifference = juce::jmax(maxDifference, difference);
+                matches = matches && difference == 0.0f;
+            }
+        }
+
+        if (!matches) {
+            ++mismatchedBlocks;
+        }
+    }
+
+    std::sort(overheads.begin(), overheads.end());
+    auto percentile = [&](double p) {
+        return overheads.empty() ? 0.0 : overheads[(size_t)(p * (double)(overheads.size() - 1))];
+    };
+
+    const double p50 = percentile(0.50);
+    const double p99 = percentile(0.99);
+    const auto stats = client->getRoundTripStats();
+
+    std::cout << "Blocks:            " << numBlocks << " x " << blockSize << " samples" << std::endl;
+    std::cout << "Mismatched blocks: " << mismatchedBlocks << " (max difference " << maxDifference << ")" << std::endl;
+    std::cout << "Bridge overhead:   p50 " << p50 << " us, p99 " << p99 << " us, max " << stats.maxMicroseconds
+              << " us (budget " << BridgeProtocol::roundTripBudgetMicroseconds << " us)" << std::endl;
+
+    bridged.unloadPlugin();
+    local.unloadPlugin();
+
+    if (mismatchedBlocks > 0) {
+        return 1;
+    }
+
+    return p99 > BridgeProtocol::roundTripBudgetMicroseconds ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i) {
+        args.add(juce::String::fromUTF8(argv[i]));
+    }
+
+    auto getOption = [&](const juce::String& name, const juce::String& fallback) {
+        int index = args.indexOf(name);
+        return (index >= 0 && index + 1 < args.size()) ? args[index + 1] : fallback;
+    };
+
+    if (args.contains("--session")) {
+        BridgeServer server;
+        return server.run(getOption("--session", {}), getOption("--parent", "0").getIntValue());
+    }
+
+    if (args.contains("--self-test")) {
+        return runSelfTest(getOption("--self-test", {}),
+                           getOption("--blocks", "2000").getIntValue(),
+                           getOption("--block-size", "256").getIntValue());
+    }
+
+    std::cout << "Usage: AltiverbBridgeHost --session <name> --parent <pid>" << std::endl;
+    std::cout << "       AltiverbBridgeHost --self-test <plugin> [--blocks N] [--block-size B]" << std::endl;
+    return 1;
+}
@@ -0,0 +1,213 @@
+#include "StandInEffect.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(_WIN32)
+  #define STANDIN_EXPORT extern "C" __declspec(dllexport)
+#else
+  #define STANDIN_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+namespace {
+
+constexpr int numChannels = 6;
+constexpr int numParams = 2;
+constexpr int numPrograms = 4;
+constexpr int uniqueId = 0x53744966;  // 'StIf'
+
+// Comb lengths are mutually prime so the channels decorrelate
+constexpr int combLengths[numChannels] = { 1117, 1193, 1277, 1361, 1439, 1511 };
+
+struct StandIn {
+    AEffect effect {};
+    AudioMasterCallback audioMaster = nullptr;
+
+    float params[numParams] = { 0.5f, 0.6f };
+    int currentProgram = 0;
+    char programNames[numPrograms][kVstMaxProgNameLen] = { "Small Room", "Hall", "Plate", "Cathedral" };
+
+    std::vector<float> delayLines[numChannels];
+    int positions[numChannels] = {};
+    float sampleRate = 44100.0f;
+
+    VstSpeakerArrangement inputArrangement {};
+    VstSpeakerArrangement outputArrangement {};
+
+    // Serialised state handed out by effGetChunk
+    std::vector<char> chunk;
+
+    void clear() {
+        for (int ch = 0; ch < numChannels; ++ch) {
+            delayLines[ch].assign((size_t)combLengths[ch], 0.0f);
+            positions[ch] = 0;
+        }
+    }
+
+    void process(float** inputs, float** outputs, int numSamples) {
+        const float mix = params[0];
+        const float feedback = params[1] * 0.85f;
+        const float crossFeed = 0.05f;
+
+        for (int i = 0; i < numSamples; ++i) {
+            float in[numChannels];
+            float wet[numChannels];
+
+            // Read every input before writing - inputs and outputs may alias
+            for (int ch = 0; ch < numChannels; ++ch) {
+                in[ch] = inputs[ch][i];
+                wet[ch] = delayLines[ch][(size_t)positions[ch]];
+            }
+
+            for (int ch = 0; ch < numChannels; ++ch) {
+                const float neighbour = wet[(ch + 1) % numChannels];
+                delayLines[ch][(size_t)positions[ch]] = in[ch] + feedback * wet[ch] + crossFeed * neighbour;
+                positions[ch] = (positions[ch] + 1) % combLengths[ch];
+
+                outputs[ch][i] = (1.0f - mix) * in[ch] + mix * wet[ch];
+            }
+        }
+    }
+
+    VstIntPtr dispatch(VstInt32 opcode, VstInt32 index, VstIntPtr value, void* ptr, float opt) {
+        switch (opcode) {
+            case effOpen:
+                clear();
+                return 0;
+
+            case effSetSampleRate:
+                sampleRate = opt;
+                return 0;
+
+            case effMainsChanged:
+                if (value) {
+                    clear();
+                }
+                return 0;
+
+            case effSetProgram:
+                if (value >= 0 && value < numPrograms) {
+                    currentProgram = (int)value;
+                }
+                return 0;
+
+            case effGetProgram:
+                return currentProgram;
+
+            case effSetProgramName:
+                std::snprintf(programNames[currentProgram], sizeof(programNames[0]), "%s", static_cast<const char*>(ptr));
+                return 0;
+
+            case effGetProgramName:
+                std::snprintf(static_cast<char*>(ptr), kVstMaxProgNameLen, "%s", programNames[currentProgram]);
+                return 0;
+
+            case effGetParamLabel:
+                std::snprintf(static_cast<char*>(ptr), kVstMaxParamStrLen, "%%");
+                return 0;
+
+            case effGetParamDisplay:
+                if (index >= 0 && index < numParams) {
+                    std::snprintf(static_cast<char*>(ptr), kVstMaxParamStrLen, "%.1f", params[index] * 100.0f);
+                }
+                return 0;
+
+            case effGetParamName:
+                std::snprintf(static_cast<char*>(ptr), kVstMaxParamStrLen, "%s", index == 0 ? "Mix" : "Feedbck");
+                return 0;
+
+            case effGetChunk: {
+                chunk.resize(sizeof(params) + sizeof(int));
+                std::memcpy(chunk.data(), params, sizeof(params));
+                std::memcpy(chunk.data() + sizeof(params), &currentProgram, sizeof(int));
+                *static_cast<void**>(ptr) = chunk.data();
+                return (VstIntPtr)chunk.size();
+            }
+
+            case effSetChunk:
+                if (value >= (VstIntPtr)(sizeof(params) + sizeof(int)) && ptr) {
+                    std::memcpy(params, ptr, sizeof(params));
+                    std::memcpy(&currentProgram, static_cast<char*>(ptr) + sizeof(params), sizeof(int));
+                    return 1;
+                }
+                return 0;
+
+            case effSetSpeakerArrangement:
+                if (value) inputArrangement = *reinterpret_cast<VstSpeakerArrangement*>(value);
+                if (ptr) outputArrangement = *static_cast<VstSpeakerArrangement*>(ptr);
+                return 1;
+
+            case effGetSpeakerArrangement:
+                if (value) *reinterpret_cast<VstSpeakerArrangement**>(value) = &inputArrangement;
+                if (ptr) *static_cast<VstSpeakerArrangement**>(ptr) = &outputArrangement;
+                return 1;
+
+            case effGetTailSize:
+                return (VstIntPtr)(combLengths[numChannels - 1] * 32);
+
+            case effCanDo:
+                return 0;
+
+            default:
+                return 0;
+        }
+    }
+};
+
+StandIn* getInstance(AEffect* effect) {
+    return static_cast<StandIn*>(effect->object);
+}
+
+VstIntPtr standInDispatcher(AEffect* effect, VstInt32 opcode, VstInt32 index, VstIntPtr value, void* ptr, float opt) {
+    StandIn* instance = getInstance(effect);
+
+    if (opcode == effClose) {
+        delete instance;
+        return 0;
+    }
+
+    return instance->dispatch(opcode, index, value, ptr, opt);
+}
+
+void standInProcessReplacing(AEffect* effect, float** inputs, float** outputs, VstInt32 sampleFrames) {
+    getInstance(effect)->process(inputs, outputs, sampleFrames);
+}
+
+void standInSetParameter(AEffect* effect, VstInt32 index, float value) {
+    if (index >= 0 && index < numParams) {
+        getInstance(effect)->params[index] = value;
+    }
+}
+
+float standInGetParameter(AEffect* effect, VstInt32 index) {
+    return (index >= 0 && index < numParams) ? getInstance(effect)->params[index] : 0.0f;
+}
+
+} // namespace
+
+AEffect* createStandInEffect(AudioMasterCallback audioMaster) {
+    StandIn* instance = new StandIn();
+    instance->audioMaster = audioMaster;
+    instance->clear();
+
+    AEffect& effect = instance->effect;
+    effect.magic = 0x56737450;  // 'VstP'
+    effect.dispatcher = standInDispatcher;
+    effect.processReplacing = standInProcessReplacing;
+    effect.setParameter = standInSetParameter;
+    effect.getParameter = standInGetParameter;
+    effect.numPrograms = numPrograms;
+    effect.numParams = numParams;
+    effect.numInputs = numChannels;
+    effect.numOutputs = numChannels;
+    effect.flags = effFlagsCanReplacing | effFlagsProgramChunks;
+    effect.uniqueID = uniqueId;
+    effect.version = 1000;
+    effect.object = instance;
+
+    return &effect;
+}
+
+STANDIN_EXPORT AEffect* VSTPluginMain(AudioMasterCallback audioMaster) {
+    return createStandInEffect(audioMaster);
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include "VST2Types.h"
+
+// Deterministic 6-in/6-out VST2 effect used in place of Altiverb where the
+// real plugin is unavailable (bridge self-test, benchmarks). A feedback comb
+// per channel with a little cross-feed gives it state and a tail, so
+// ordering or routing mistakes show up as sample differences.
+//
+// Parameters: 0 = mix, 1 = feedback. Safe to process in place.
+
+// Create an instance without going through a shared library
+AEffect* createStandInEffect(AudioMasterCallback audioMaster);